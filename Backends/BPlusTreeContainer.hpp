@@ -0,0 +1,461 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <cstddef>
+
+namespace ex4 {
+
+template <typename T, std::size_t NodeBytes> class BPlusTreeContainer;
+
+/**
+ * @class BPlusTreeOrder
+ * @brief Iterator over a BPlusTreeContainer in ascending (or descending) order.
+ *
+ * Scans the doubly linked leaf chain: O(1) per step, with each leaf a contiguous array.
+ * No copy is made, so the iterator is invalidated by any mutation of the container.
+ */
+template <typename T, std::size_t NodeBytes>
+class BPlusTreeOrder {
+    using Leaf = typename BPlusTreeContainer<T, NodeBytes>::Leaf;
+    const Leaf* leaf;   /** Current leaf (nullptr = end). */
+    std::size_t pos;    /** Slot within the leaf. */
+    bool descending;    /** true: walk slots and leaves backwards. */
+
+public:
+    BPlusTreeOrder(const Leaf* l, std::size_t p, bool desc) : leaf(l), pos(p), descending(desc) {}
+
+    /**
+     * @brief Dereference operator (read-only).
+     * @throws std::out_of_range at the end position.
+     */
+    const T& operator*() const {
+        if (!leaf) throw std::out_of_range("Iterator is out of range");
+        return leaf->keys[pos];
+    }
+    const T* operator->() const { return &**this; }
+
+    BPlusTreeOrder& operator++() {
+        if (!descending) {
+            if (++pos == leaf->count) {
+                leaf = leaf->next;
+                pos = 0;
+            }
+        } else if (pos > 0) {
+            --pos;
+        } else {
+            leaf = leaf->prev;
+            pos = leaf ? leaf->count - 1 : 0;
+        }
+        return *this;
+    }
+    BPlusTreeOrder operator++(int) {
+        BPlusTreeOrder tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const BPlusTreeOrder& other) const { return leaf == other.leaf && pos == other.pos; }
+    bool operator!=(const BPlusTreeOrder& other) const { return !(*this == other); }
+};
+
+/**
+ * @class BPlusTreeContainer
+ * @brief Ordered multiset backend for large, frequently mutated containers.
+ *
+ * Overview:
+ *  - A B+tree whose nodes are sized to `NodeBytes` (default: one 4 KiB page) and aligned to
+ *    cache lines, so a lookup touches O(log_B n) pages and scans stay in contiguous arrays.
+ *  - All values live in the leaves, which form a doubly linked chain: ascending and
+ *    descending traversals are plain leaf-chain scans.
+ *  - `addElement` is O(log n) (nodes are split on the way down); `removeElement` is
+ *    O(log n) per leaf holding occurrences, with underfull nodes refilled from a sibling
+ *    or merged on the way back up.
+ *  - Equal values keep insertion order (a value goes after its equals).
+ *  - Only the sorted orders exist: the tree does not record insertion order.
+ */
+template <typename T, std::size_t NodeBytes = 4096>
+class BPlusTreeContainer {
+    struct Node {
+        bool leaf;              /** true for Leaf, false for Inner. */
+        std::size_t count = 0;  /** Keys in use. */
+        explicit Node(bool isLeaf) : leaf(isLeaf) {}
+    };
+
+    static constexpr std::size_t kHeader = sizeof(Node) + 2 * sizeof(void*);
+
+public:
+    /** Keys per leaf / separator keys per inner node (at least 4 each). */
+    static constexpr std::size_t kLeafCapacity =
+        NodeBytes > kHeader + 4 * sizeof(T) ? (NodeBytes - kHeader) / sizeof(T) : 4;
+    static constexpr std::size_t kInnerCapacity =
+        NodeBytes > kHeader + 4 * (sizeof(T) + sizeof(void*)) ? (NodeBytes - kHeader) / (sizeof(T) + sizeof(void*)) : 4;
+
+    struct alignas(64) Leaf : Node {
+        Leaf* prev = nullptr;   /** Previous leaf in key order. */
+        Leaf* next = nullptr;   /** Next leaf in key order. */
+        T keys[kLeafCapacity];
+        Leaf() : Node(true) {}
+    };
+
+private:
+    /** Child i holds keys k with keys[i-1] <= k <= keys[i]. */
+    struct alignas(64) Inner : Node {
+        T keys[kInnerCapacity];
+        Node* children[kInnerCapacity + 1];
+        Inner() : Node(false) {}
+    };
+
+    static constexpr std::size_t kLeafMin = kLeafCapacity / 2;
+    static constexpr std::size_t kInnerMin = (kInnerCapacity - 1) / 2;
+
+    Node* root;
+    Leaf* first;              /** Leftmost leaf. */
+    Leaf* last;               /** Rightmost leaf. */
+    std::size_t count = 0;    /** Number of elements. */
+
+    friend class BPlusTreeOrder<T, NodeBytes>;
+
+    static Leaf* asLeaf(Node* n) { return static_cast<Leaf*>(n); }
+    static Inner* asInner(Node* n) { return static_cast<Inner*>(n); }
+    static const Leaf* asLeaf(const Node* n) { return static_cast<const Leaf*>(n); }
+    static const Inner* asInner(const Node* n) { return static_cast<const Inner*>(n); }
+
+    static std::size_t capacityOf(const Node* n) { return n->leaf ? kLeafCapacity : kInnerCapacity; }
+    static std::size_t minimumOf(const Node* n) { return n->leaf ? kLeafMin : kInnerMin; }
+
+    static void destroy(Node* n) {
+        if (!n->leaf) {
+            Inner* in = asInner(n);
+            for (std::size_t i = 0; i <= in->count; ++i) destroy(in->children[i]);
+            delete in;
+        } else {
+            delete asLeaf(n);
+        }
+    }
+
+    void reset() {
+        Leaf* l = new Leaf();
+        root = l;
+        first = last = l;
+        count = 0;
+    }
+
+    /** @brief Split the full child `i` of `parent` (which is not full) into two halves. */
+    void splitChild(Inner* parent, std::size_t i) {
+        Node* child = parent->children[i];
+        Node* right;
+        T separator;
+        if (child->leaf) {
+            Leaf* l = asLeaf(child);
+            Leaf* r = new Leaf();
+            const std::size_t mid = l->count / 2;
+            std::move(l->keys + mid, l->keys + l->count, r->keys);
+            r->count = l->count - mid;
+            l->count = mid;
+            r->next = l->next;
+            r->prev = l;
+            if (l->next) l->next->prev = r;
+            else last = r;
+            l->next = r;
+            separator = r->keys[0];
+            right = r;
+        } else {
+            Inner* l = asInner(child);
+            Inner* r = new Inner();
+            const std::size_t mid = l->count / 2;
+            separator = std::move(l->keys[mid]);
+            std::move(l->keys + mid + 1, l->keys + l->count, r->keys);
+            std::copy(l->children + mid + 1, l->children + l->count + 1, r->children);
+            r->count = l->count - mid - 1;
+            l->count = mid;
+            right = r;
+        }
+        std::move_backward(parent->keys + i, parent->keys + parent->count, parent->keys + parent->count + 1);
+        std::copy_backward(parent->children + i + 1, parent->children + parent->count + 1,
+                           parent->children + parent->count + 2);
+        parent->keys[i] = std::move(separator);
+        parent->children[i + 1] = right;
+        ++parent->count;
+    }
+
+    /** @brief Remove separator `i` and child `i + 1` from an inner node. */
+    static void eraseSlot(Inner* in, std::size_t i) {
+        std::move(in->keys + i + 1, in->keys + in->count, in->keys + i);
+        std::copy(in->children + i + 2, in->children + in->count + 1, in->children + i + 1);
+        --in->count;
+    }
+
+    /** @brief Append child `i + 1` of `parent` (and the separator between them) to child `i`. */
+    void mergeChildren(Inner* parent, std::size_t i) {
+        Node* left = parent->children[i];
+        Node* right = parent->children[i + 1];
+        if (left->leaf) {
+            Leaf* l = asLeaf(left);
+            Leaf* r = asLeaf(right);
+            std::move(r->keys, r->keys + r->count, l->keys + l->count);
+            l->count += r->count;
+            l->next = r->next;
+            if (r->next) r->next->prev = l;
+            else last = l;
+            delete r;
+        } else {
+            Inner* l = asInner(left);
+            Inner* r = asInner(right);
+            l->keys[l->count] = std::move(parent->keys[i]);
+            std::move(r->keys, r->keys + r->count, l->keys + l->count + 1);
+            std::copy(r->children, r->children + r->count + 1, l->children + l->count + 1);
+            l->count += r->count + 1;
+            delete r;
+        }
+        eraseSlot(parent, i);
+    }
+
+    /** @brief Move the last `k` keys of child `i - 1` to the front of child `i`. */
+    static void borrowFromLeft(Inner* parent, std::size_t i, std::size_t k) {
+        Node* left = parent->children[i - 1];
+        Node* child = parent->children[i];
+        if (child->leaf) {
+            Leaf* l = asLeaf(left);
+            Leaf* c = asLeaf(child);
+            std::move_backward(c->keys, c->keys + c->count, c->keys + c->count + k);
+            std::move(l->keys + l->count - k, l->keys + l->count, c->keys);
+            l->count -= k;
+            c->count += k;
+            parent->keys[i - 1] = c->keys[0];
+        } else {
+            Inner* l = asInner(left);
+            Inner* c = asInner(child);
+            std::move_backward(c->keys, c->keys + c->count, c->keys + c->count + k);
+            std::copy_backward(c->children, c->children + c->count + 1, c->children + c->count + 1 + k);
+            c->keys[k - 1] = std::move(parent->keys[i - 1]);
+            std::move(l->keys + l->count - k + 1, l->keys + l->count, c->keys);
+            std::copy(l->children + l->count - k + 1, l->children + l->count + 1, c->children);
+            parent->keys[i - 1] = std::move(l->keys[l->count - k]);
+            l->count -= k;
+            c->count += k;
+        }
+    }
+
+    /** @brief Move the first `k` keys of child `i + 1` to the back of child `i`. */
+    static void borrowFromRight(Inner* parent, std::size_t i, std::size_t k) {
+        Node* child = parent->children[i];
+        Node* right = parent->children[i + 1];
+        if (child->leaf) {
+            Leaf* c = asLeaf(child);
+            Leaf* r = asLeaf(right);
+            std::move(r->keys, r->keys + k, c->keys + c->count);
+            std::move(r->keys + k, r->keys + r->count, r->keys);
+            c->count += k;
+            r->count -= k;
+            parent->keys[i] = r->keys[0];
+        } else {
+            Inner* c = asInner(child);
+            Inner* r = asInner(right);
+            c->keys[c->count] = std::move(parent->keys[i]);
+            std::move(r->keys, r->keys + k - 1, c->keys + c->count + 1);
+            std::copy(r->children, r->children + k, c->children + c->count + 1);
+            parent->keys[i] = std::move(r->keys[k - 1]);
+            std::move(r->keys + k, r->keys + r->count, r->keys);
+            std::copy(r->children + k, r->children + r->count + 1, r->children);
+            c->count += k;
+            r->count -= k;
+        }
+    }
+
+    /**
+     * @brief Restore the minimum fill of child `i`.
+     *
+     * Merges with a sibling when both fit in one node, otherwise moves keys over from the
+     * sibling so the two end up evenly filled (a bulk removal may leave `i` far below minimum).
+     */
+    void rebalance(Inner* parent, std::size_t i) {
+        Node* child = parent->children[i];
+        if (child->count >= minimumOf(child)) return;
+        const std::size_t s = i > 0 ? i - 1 : i + 1;           /** Prefer the left sibling. */
+        const std::size_t combined = child->count + parent->children[s]->count + (child->leaf ? 0 : 1);
+        if (combined <= capacityOf(child)) {
+            mergeChildren(parent, std::min(i, s));
+            return;
+        }
+        const std::size_t k = (parent->children[s]->count - child->count) / 2;
+        if (s < i) borrowFromLeft(parent, i, k);
+        else borrowFromRight(parent, i, k);
+    }
+
+    /**
+     * @brief Remove the keys equal to `value` stored in the first leaf below `n` holding any.
+     * @return Number of keys removed (0 if `value` is absent).
+     *
+     * Descends to the leftmost leaf that may hold `value` and fixes underfull nodes on the
+     * way back up, so only one child per level is ever rebalanced. A separator equivalent to
+     * `value` means equivalent keys may continue in the next child, which is then tried; only
+     * keys that are also `==` to `value` are removed.
+     */
+    std::size_t eraseFirstRun(Node* n, const T& value) {
+        if (n->leaf) {
+            Leaf* l = asLeaf(n);
+            T* lo = std::lower_bound(l->keys, l->keys + l->count, value);
+            T* hi = std::upper_bound(lo, l->keys + l->count, value);
+            T* kept = std::remove(lo, hi, value);           /** Equivalent keys may differ: keep non-equal ones. */
+            const std::size_t removed = static_cast<std::size_t>(hi - kept);
+            if (removed == 0) return 0;                   /** Avoid self-move of the keys. */
+            std::move(hi, l->keys + l->count, kept);
+            l->count -= removed;
+            return removed;
+        }
+        Inner* in = asInner(n);
+        for (std::size_t i = static_cast<std::size_t>(std::lower_bound(in->keys, in->keys + in->count, value) - in->keys);
+             i <= in->count; ++i) {
+            if (const std::size_t removed = eraseFirstRun(in->children[i], value)) {
+                rebalance(in, i);
+                return removed;
+            }
+            if (i == in->count || value < in->keys[i]) break;
+        }
+        return 0;
+    }
+
+    /** @return Leaf and slot of the first key not less than `value` (leaf nullptr if none). */
+    std::pair<const Leaf*, std::size_t> lowerBound(const T& value) const {
+        const Node* n = root;
+        while (!n->leaf) {
+            const Inner* in = asInner(n);
+            n = in->children[std::lower_bound(in->keys, in->keys + in->count, value) - in->keys];
+        }
+        const Leaf* l = asLeaf(n);
+        std::size_t pos = static_cast<std::size_t>(std::lower_bound(l->keys, l->keys + l->count, value) - l->keys);
+        if (pos == l->count) {
+            l = l->next;        /** Separator range admitted `value`, but every key here is smaller. */
+            pos = 0;
+        }
+        return {l, pos};
+    }
+
+public:
+    BPlusTreeContainer() { reset(); }
+    ~BPlusTreeContainer() { destroy(root); }
+
+    BPlusTreeContainer(const BPlusTreeContainer& other) : BPlusTreeContainer() {
+        for (auto it = other.begin_ascending_order(); it != other.end_ascending_order(); ++it) addElement(*it);
+    }
+
+    BPlusTreeContainer& operator=(const BPlusTreeContainer& other) {
+        if (this != &other) {
+            destroy(root);
+            reset();
+            for (auto it = other.begin_ascending_order(); it != other.end_ascending_order(); ++it) addElement(*it);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Insert a value after any equal values.
+     * Complexity: O(log n).
+     */
+    void addElement(const T& value) {
+        if (root->count == capacityOf(root)) {
+            Inner* top = new Inner();
+            top->children[0] = root;
+            root = top;
+            splitChild(top, 0);
+        }
+        Node* n = root;
+        while (!n->leaf) {
+            Inner* in = asInner(n);
+            std::size_t i = static_cast<std::size_t>(std::upper_bound(in->keys, in->keys + in->count, value) - in->keys);
+            if (in->children[i]->count == capacityOf(in->children[i])) {
+                splitChild(in, i);
+                if (!(value < in->keys[i])) ++i;
+            }
+            n = in->children[i];
+        }
+        Leaf* l = asLeaf(n);
+        T* pos = std::upper_bound(l->keys, l->keys + l->count, value);
+        std::move_backward(pos, l->keys + l->count, l->keys + l->count + 1);
+        *pos = value;
+        ++l->count;
+        ++count;
+    }
+
+    /**
+     * @brief Remove all occurrences of a value.
+     * @throws std::runtime_error if the value does not exist in the container.
+     * Complexity: O(log n) per leaf holding occurrences (O(log n + k) for k occurrences).
+     */
+    void removeElement(const T& value) {
+        std::size_t removed = 0;
+        while (const std::size_t run = eraseFirstRun(root, value)) {
+            removed += run;
+            while (!root->leaf && root->count == 0) {     /** Collapse a root left with one child. */
+                Inner* old = asInner(root);
+                root = old->children[0];
+                delete old;
+            }
+        }
+        if (removed == 0) throw std::runtime_error("This element does not exist in the container");
+        count -= removed;
+    }
+
+    /**
+     * @return true if an element equal to `value` exists.
+     * Complexity: O(log n + k), walking the k keys equivalent to `value` (which may be unequal).
+     */
+    bool contains(const T& value) const {
+        for (auto [l, pos] = lowerBound(value); l; l = l->next, pos = 0) {
+            for (; pos < l->count; ++pos) {
+                if (value < l->keys[pos]) return false;   /** Past the equivalent range. */
+                if (l->keys[pos] == value) return true;
+            }
+        }
+        return false;
+    }
+
+    /** @return Number of elements. */
+    std::size_t size() const { return count; }
+
+    /** @return Number of node levels (1 while the root is a leaf). */
+    std::size_t height() const {
+        std::size_t h = 1;
+        for (const Node* n = root; !n->leaf; n = asInner(n)->children[0]) ++h;
+        return h;
+    }
+
+    /**
+     * @brief Smallest / largest element.
+     * @throws std::runtime_error if the container is empty.
+     * Complexity: O(1).
+     */
+    const T& min() const {
+        if (count == 0) throw std::runtime_error("The container is empty");
+        return first->keys[0];
+    }
+    const T& max() const {
+        if (count == 0) throw std::runtime_error("The container is empty");
+        return last->keys[last->count - 1];
+    }
+
+    // ===== Iterator entry points (leaf-chain scans, invalidated by mutation) =====
+
+    /** @return begin/end for ascending sorted traversal. */
+    BPlusTreeOrder<T, NodeBytes> begin_ascending_order() const {
+        return BPlusTreeOrder<T, NodeBytes>(count ? first : nullptr, 0, false);
+    }
+    BPlusTreeOrder<T, NodeBytes> end_ascending_order() const { return BPlusTreeOrder<T, NodeBytes>(nullptr, 0, false); }
+
+    /** @return begin/end for descending sorted traversal. */
+    BPlusTreeOrder<T, NodeBytes> begin_descending_order() const {
+        return BPlusTreeOrder<T, NodeBytes>(count ? last : nullptr, count ? last->count - 1 : 0, true);
+    }
+    BPlusTreeOrder<T, NodeBytes> end_descending_order() const { return BPlusTreeOrder<T, NodeBytes>(nullptr, 0, true); }
+
+    /** @brief Print the elements in ascending order as "x y z \n". */
+    friend std::ostream& operator<<(std::ostream& os, const BPlusTreeContainer& c) {
+        for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) os << *it << ' ';
+        os << std::endl;
+        return os;
+    }
+};
+
+}
@@ -0,0 +1,285 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+
+namespace ex4 {
+
+template <typename T> class ConcurrentSkipListContainer;
+
+/**
+ * @class ConcurrentSkipListOrder
+ * @brief Weakly consistent iterator over a ConcurrentSkipListContainer (ascending or descending).
+ *
+ * Overview:
+ *  - Walks the live list without locks and without copying; concurrent inserts may or may
+ *    not be observed, removed elements are skipped, and every step stays in sorted order.
+ *  - Ascending steps follow level-0 links (O(1)); descending steps search the predecessor
+ *    from the top level (O(log n) expected), since the list is singly linked.
+ */
+template <typename T>
+class ConcurrentSkipListOrder {
+    using List = ConcurrentSkipListContainer<T>;
+    using Node = typename List::Node;
+
+    const List* list;   /** Owning container (used for predecessor searches). */
+    const Node* node;   /** Current node (nullptr = end). */
+    bool descending;    /** Direction of traversal. */
+
+public:
+    ConcurrentSkipListOrder(const List* l, const Node* n, bool desc) : list(l), node(n), descending(desc) {}
+
+    /**
+     * @brief Dereference operator (read-only).
+     * @throws std::out_of_range at the end position.
+     */
+    const T& operator*() const {
+        if (!node) throw std::out_of_range("Iterator is out of range");
+        return node->value;
+    }
+    const T* operator->() const { return &**this; }
+
+    ConcurrentSkipListOrder& operator++() {
+        node = descending ? list->livePredecessor(node) : list->liveSuccessor(node);
+        return *this;
+    }
+    ConcurrentSkipListOrder operator++(int) {
+        ConcurrentSkipListOrder tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const ConcurrentSkipListOrder& other) const { return node == other.node; }
+    bool operator!=(const ConcurrentSkipListOrder& other) const { return !(*this == other); }
+};
+
+/**
+ * @class ConcurrentSkipListContainer
+ * @brief Ordered multiset backend with lock-free concurrent inserts and traversals.
+ *
+ * Overview:
+ *  - A lock-free skip list: `addElement` links a node level by level with CAS, retrying
+ *    a level when it races with another insert. Many threads may insert at once while
+ *    others traverse; no global sort is ever needed.
+ *  - `removeElement` is a logical delete (an atomic flag per node), so readers never see
+ *    freed memory. Deleted nodes stay linked until `compact()` is called while no other
+ *    thread uses the container, or until destruction.
+ *  - Equal values keep insertion order (a node goes after its equals).
+ *  - Traversals are weakly consistent: each one is sorted and never shows an element twice.
+ */
+template <typename T>
+class ConcurrentSkipListContainer {
+public:
+    static constexpr std::size_t kMaxLevel = 24;
+
+    struct Node {
+        T value;
+        std::atomic<bool> deleted{false};
+        std::size_t height;
+        std::atomic<Node*>* next;   /** `height` forward links. */
+
+        Node(const T& v, std::size_t h) : value(v), height(h), next(new std::atomic<Node*>[h]) {
+            for (std::size_t l = 0; l < h; ++l) next[l].store(nullptr, std::memory_order_relaxed);
+        }
+        ~Node() { delete[] next; }
+        Node(const Node&) = delete;
+        Node& operator=(const Node&) = delete;
+    };
+
+private:
+    std::atomic<Node*> head[kMaxLevel];      /** Sentinel links per level. */
+    std::atomic<std::size_t> live{0};        /** Number of non-deleted elements. */
+
+    friend class ConcurrentSkipListOrder<T>;
+
+    /** @return A random height in [1, kMaxLevel] with P(height > k) = 4^-k. */
+    static std::size_t randomLevel() {
+        thread_local std::uint64_t s = 0x9E3779B97F4A7C15ULL ^ reinterpret_cast<std::uintptr_t>(&s);
+        std::size_t lvl = 1;
+        while (lvl < kMaxLevel) {
+            s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+            if ((s & 3U) != 0) break;
+            ++lvl;
+        }
+        return lvl;
+    }
+
+    /** @return Link `l` of `pred` (nullptr pred means the head sentinel). */
+    std::atomic<Node*>& link(Node* pred, std::size_t l) const {
+        return pred ? pred->next[l] : const_cast<std::atomic<Node*>&>(head[l]);
+    }
+
+    /**
+     * @brief For each level, find the last node not greater than `value` and its successor.
+     * @param preds Receives predecessors (nullptr = head).
+     * @param succs Receives successors (first node greater than `value`, or nullptr).
+     */
+    void findInsertPosition(const T& value, Node** preds, Node** succs) const {
+        Node* pred = nullptr;
+        for (std::size_t l = kMaxLevel; l-- > 0;) {
+            Node* cur = link(pred, l).load(std::memory_order_acquire);
+            while (cur && !(value < cur->value)) {
+                pred = cur;
+                cur = cur->next[l].load(std::memory_order_acquire);
+            }
+            preds[l] = pred;
+            succs[l] = cur;
+        }
+    }
+
+    /** @return First node not less than `value` (may be deleted), or nullptr. */
+    Node* lowerBound(const T& value) const {
+        Node* pred = nullptr;
+        for (std::size_t l = kMaxLevel; l-- > 0;) {
+            Node* cur = link(pred, l).load(std::memory_order_acquire);
+            while (cur && cur->value < value) {
+                pred = cur;
+                cur = cur->next[l].load(std::memory_order_acquire);
+            }
+        }
+        return link(pred, 0).load(std::memory_order_acquire);
+    }
+
+    /** @return First live node at or after `n` along level 0. */
+    static const Node* skipDeleted(const Node* n) {
+        while (n && n->deleted.load(std::memory_order_acquire)) n = n->next[0].load(std::memory_order_acquire);
+        return n;
+    }
+
+    const Node* liveSuccessor(const Node* n) const {
+        return skipDeleted(n->next[0].load(std::memory_order_acquire));
+    }
+
+    /** @return Live node immediately before `n` in sorted order, or nullptr. */
+    const Node* livePredecessor(const Node* n) const {
+        for (;;) {
+            Node* pred = nullptr;
+            for (std::size_t l = kMaxLevel; l-- > 0;) {
+                Node* cur = link(pred, l).load(std::memory_order_acquire);
+                while (cur && cur->value < n->value) {
+                    pred = cur;
+                    cur = cur->next[l].load(std::memory_order_acquire);
+                }
+            }
+            /** Walk through equal values (and any concurrent inserts) up to `n` itself. */
+            for (Node* cur = link(pred, 0).load(std::memory_order_acquire); cur != n;
+                 cur = cur->next[0].load(std::memory_order_acquire)) {
+                pred = cur;
+            }
+            if (!pred || !pred->deleted.load(std::memory_order_acquire)) return pred;
+            n = pred;                                             /** Skip a deleted predecessor. */
+        }
+    }
+
+    void destroyAll() {
+        Node* n = head[0].load(std::memory_order_relaxed);
+        while (n) {
+            Node* next = n->next[0].load(std::memory_order_relaxed);
+            delete n;
+            n = next;
+        }
+        for (auto& h : head) h.store(nullptr, std::memory_order_relaxed);
+    }
+
+public:
+    ConcurrentSkipListContainer() {
+        for (auto& h : head) h.store(nullptr, std::memory_order_relaxed);
+    }
+    ~ConcurrentSkipListContainer() { destroyAll(); }
+
+    ConcurrentSkipListContainer(const ConcurrentSkipListContainer&) = delete;
+    ConcurrentSkipListContainer& operator=(const ConcurrentSkipListContainer&) = delete;
+
+    /**
+     * @brief Insert a value (thread-safe, lock-free).
+     * Complexity: O(log n) expected, plus retries under contention.
+     */
+    void addElement(const T& value) {
+        const std::size_t h = randomLevel();
+        Node* node = new Node(value, h);
+        Node* preds[kMaxLevel];
+        Node* succs[kMaxLevel];
+        findInsertPosition(value, preds, succs);
+
+        for (std::size_t l = 0; l < h; ++l) {
+            for (;;) {
+                node->next[l].store(succs[l], std::memory_order_relaxed);
+                Node* expected = succs[l];
+                if (link(preds[l], l).compare_exchange_strong(expected, node, std::memory_order_release,
+                                                              std::memory_order_relaxed)) {
+                    break;
+                }
+                findInsertPosition(value, preds, succs);      /** Lost a race: re-read the neighbours. */
+            }
+        }
+        live.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Logically remove all occurrences of a value (thread-safe).
+     * @throws std::runtime_error if no live occurrence exists.
+     * Complexity: O(log n + occurrences) expected.
+     */
+    void removeElement(const T& value) {
+        std::size_t removed = 0;
+        for (Node* n = lowerBound(value); n && !(value < n->value); n = n->next[0].load(std::memory_order_acquire)) {
+            bool was = false;
+            if (n->value == value && n->deleted.compare_exchange_strong(was, true)) ++removed;
+        }
+        if (removed == 0) throw std::runtime_error("This element does not exist in the container");
+        live.fetch_sub(removed, std::memory_order_relaxed);
+    }
+
+    /** @return true if a live element equal to `value` exists. O(log n) expected. */
+    bool contains(const T& value) const {
+        for (const Node* n = lowerBound(value); n && !(value < n->value); n = n->next[0].load(std::memory_order_acquire)) {
+            if (n->value == value && !n->deleted.load(std::memory_order_acquire)) return true;
+        }
+        return false;
+    }
+
+    /** @return Number of live elements (exact when no operation is in flight). */
+    std::size_t size() const { return live.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Free logically deleted nodes.
+     * @warning Not thread-safe: call only while no other thread uses the container.
+     */
+    void compact() {
+        std::vector<T> keep;
+        keep.reserve(size());
+        for (const Node* n = skipDeleted(head[0].load(std::memory_order_relaxed)); n; n = liveSuccessor(n)) {
+            keep.push_back(n->value);
+        }
+        destroyAll();
+        live.store(0, std::memory_order_relaxed);
+        for (const T& v : keep) addElement(v);
+    }
+
+    // ===== Iterator entry points (weakly consistent, no snapshot) =====
+
+    /** @return begin/end for ascending sorted traversal. */
+    ConcurrentSkipListOrder<T> begin_ascending_order() const {
+        return ConcurrentSkipListOrder<T>(this, skipDeleted(head[0].load(std::memory_order_acquire)), false);
+    }
+    ConcurrentSkipListOrder<T> end_ascending_order() const { return ConcurrentSkipListOrder<T>(this, nullptr, false); }
+
+    /** @return begin/end for descending sorted traversal (starts at the current maximum). */
+    ConcurrentSkipListOrder<T> begin_descending_order() const {
+        Node* pred = nullptr;
+        for (std::size_t l = kMaxLevel; l-- > 0;) {
+            for (Node* cur = link(pred, l).load(std::memory_order_acquire); cur;
+                 cur = cur->next[l].load(std::memory_order_acquire)) {
+                pred = cur;
+            }
+        }
+        const Node* last = pred;
+        if (last && last->deleted.load(std::memory_order_acquire)) last = livePredecessor(last);
+        return ConcurrentSkipListOrder<T>(this, last, true);
+    }
+    ConcurrentSkipListOrder<T> end_descending_order() const { return ConcurrentSkipListOrder<T>(this, nullptr, true); }
+};
+
+}
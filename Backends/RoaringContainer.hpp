@@ -0,0 +1,478 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace ex4 {
+
+template <typename T> class MyContainer;
+class RoaringContainer;
+
+/** Traversal modes offered by RoaringContainer. */
+enum class RoaringMode { Ascending, Descending, SideCross };
+
+/**
+ * @class RoaringOrder
+ * @brief Iterator over a RoaringContainer in ascending, descending or side-cross order.
+ *
+ * Walks set bits (bitmap chunks, via count-trailing/leading-zeros) or sorted 16-bit lows
+ * (array chunks) in place: no copy, and invalidated by any mutation of the container.
+ * Side-cross keeps one cursor at each end and alternates between them.
+ */
+class RoaringOrder {
+public:
+    /** Position inside the container: chunk number, then array slot or bit number. */
+    struct Cursor {
+        std::size_t chunk;
+        std::uint32_t pos;
+    };
+
+private:
+    const RoaringContainer* owner;  /** Container being traversed. */
+    Cursor front;                   /** Next value from the low end. */
+    Cursor back;                    /** Next value from the high end. */
+    std::size_t idx;                /** Values produced so far. */
+    std::size_t n;                  /** Total values (end when idx == n). */
+    RoaringMode mode;
+
+    bool usesFront() const { return mode == RoaringMode::Ascending || (mode == RoaringMode::SideCross && idx % 2 == 0); }
+
+public:
+    RoaringOrder(const RoaringContainer* c, Cursor f, Cursor b, std::size_t i, std::size_t total, RoaringMode m)
+        : owner(c), front(f), back(b), idx(i), n(total), mode(m) {}
+
+    /**
+     * @brief Dereference operator (by value: the element is reconstructed from its bit).
+     * @throws std::out_of_range at the end position.
+     */
+    std::uint32_t operator*() const;
+
+    RoaringOrder& operator++();
+    RoaringOrder operator++(int) {
+        RoaringOrder tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const RoaringOrder& other) const {
+        return owner == other.owner && idx == other.idx && mode == other.mode;
+    }
+    bool operator!=(const RoaringOrder& other) const { return !(*this == other); }
+};
+
+/**
+ * @class RoaringContainer
+ * @brief Set of 32-bit unsigned integers stored as a roaring bitmap.
+ *
+ * Overview:
+ *  - Values are split into a 16-bit chunk key (high bits) and a 16-bit low part. Each chunk
+ *    holds its lows either as a sorted array (sparse: up to 4096 values, 8 KiB at most) or as
+ *    a 65536-bit bitmap (dense: 1024 words, 8 KiB).
+ *  - Duplicates collapse: this is a set, meant for dense id sets whose sorted views ignore
+ *    multiplicity. `addElement` of a present value is a no-op.
+ *  - Membership costs a search among chunk keys plus one bit test or a binary search in at
+ *    most 4096 lows. Insertion and removal are O(1) bit operations in a bitmap chunk but shift
+ *    up to 4095 lows (8 KiB) in an array chunk; none depends on the number of elements.
+ *  - Union, intersection and difference (`|`, `&`, `-`) combine bitmap chunks 128 bits at a
+ *    time with SSE2 word operations (plain 64-bit words without SSE2).
+ */
+class RoaringContainer {
+    static constexpr std::size_t kArrayMax = 4096;            /** Largest array chunk. */
+    static constexpr std::size_t kWords = 65536 / 64;         /** Words per bitmap chunk. */
+
+    /** @return Index of the lowest set bit of a non-zero word. */
+    static unsigned lowestBit(std::uint64_t m) {
+#if defined(__GNUC__)
+        return static_cast<unsigned>(__builtin_ctzll(m));
+#else
+        unsigned n = 0;
+        for (; !(m & 1); m >>= 1) ++n;
+        return n;
+#endif
+    }
+
+    /** @return Index of the highest set bit of a non-zero word. */
+    static unsigned highestBit(std::uint64_t m) {
+#if defined(__GNUC__)
+        return 63U - static_cast<unsigned>(__builtin_clzll(m));
+#else
+        unsigned n = 0;
+        while (m >>= 1) ++n;
+        return n;
+#endif
+    }
+
+    /** @return Number of set bits in a word. */
+    static std::size_t popcount(std::uint64_t m) {
+#if defined(__GNUC__)
+        return static_cast<std::size_t>(__builtin_popcountll(m));
+#else
+        std::size_t n = 0;
+        for (; m; m &= m - 1) ++n;
+        return n;
+#endif
+    }
+
+    struct Chunk {
+        std::uint16_t key = 0;                 /** High 16 bits shared by the chunk. */
+        std::vector<std::uint16_t> array;      /** Sorted lows (array form). */
+        std::vector<std::uint64_t> words;      /** kWords bits (bitmap form; empty in array form). */
+        std::size_t cardinality = 0;
+
+        bool isBitmap() const { return !words.empty(); }
+
+        bool test(std::uint16_t low) const {
+            if (isBitmap()) return (words[low >> 6] >> (low & 63)) & 1U;
+            return std::binary_search(array.begin(), array.end(), low);
+        }
+
+        void toBitmap() {
+            words.assign(kWords, 0);
+            for (std::uint16_t low : array) words[low >> 6] |= std::uint64_t(1) << (low & 63);
+            array.clear();
+            array.shrink_to_fit();
+        }
+
+        void toArray() {
+            array.clear();
+            array.reserve(cardinality);
+            for (std::size_t w = 0; w < kWords; ++w) {
+                for (std::uint64_t m = words[w]; m; m &= m - 1) {
+                    array.push_back(static_cast<std::uint16_t>(w * 64 + lowestBit(m)));
+                }
+            }
+            words.clear();
+            words.shrink_to_fit();
+        }
+
+        /** @return Bitmap words of this chunk: `words` itself, or `scratch` filled from the array. */
+        const std::vector<std::uint64_t>& bitmapWords(std::vector<std::uint64_t>& scratch) const {
+            if (isBitmap()) return words;
+            scratch.assign(kWords, 0);
+            for (std::uint16_t low : array) scratch[low >> 6] |= std::uint64_t(1) << (low & 63);
+            return scratch;
+        }
+    };
+
+    std::vector<Chunk> chunks;     /** Non-empty chunks, ascending by key. */
+    std::size_t count = 0;         /** Number of values. */
+
+    friend class RoaringOrder;
+
+    static std::uint16_t high(std::uint32_t v) { return static_cast<std::uint16_t>(v >> 16); }
+    static std::uint16_t low(std::uint32_t v) { return static_cast<std::uint16_t>(v & 0xFFFF); }
+
+    /** @return Index of the first chunk whose key is not less than `key`. */
+    std::size_t chunkIndex(std::uint16_t key) const {
+        return static_cast<std::size_t>(std::lower_bound(chunks.begin(), chunks.end(), key,
+            [](const Chunk& c, std::uint16_t k) { return c.key < k; }) - chunks.begin());
+    }
+
+    const Chunk* findChunk(std::uint16_t key) const {
+        const std::size_t i = chunkIndex(key);
+        return (i < chunks.size() && chunks[i].key == key) ? &chunks[i] : nullptr;
+    }
+
+    // ===== Cursor movement (used by RoaringOrder) =====
+
+    RoaringOrder::Cursor firstCursor() const {
+        if (chunks.empty()) return {0, 0};
+        const Chunk& c = chunks.front();
+        return {0, c.isBitmap() ? nextBit(c, 0, true) : 0U};
+    }
+
+    RoaringOrder::Cursor lastCursor() const {
+        if (chunks.empty()) return {0, 0};
+        const Chunk& c = chunks.back();
+        return {chunks.size() - 1, c.isBitmap() ? prevBit(c, 65535, true)
+                                                : static_cast<std::uint32_t>(c.array.size() - 1)};
+    }
+
+    /** @return First set bit at or after (`inclusive`) / strictly after `pos`, or 65536. */
+    static std::uint32_t nextBit(const Chunk& c, std::uint32_t pos, bool inclusive) {
+        if (!inclusive && ++pos > 65535) return 65536;
+        std::size_t w = pos >> 6;
+        std::uint64_t m = c.words[w] & (~std::uint64_t(0) << (pos & 63));
+        while (m == 0) {
+            if (++w == kWords) return 65536;
+            m = c.words[w];
+        }
+        return static_cast<std::uint32_t>(w * 64 + lowestBit(m));
+    }
+
+    /** @return Last set bit at or before (`inclusive`) / strictly before `pos`, or 65536. */
+    static std::uint32_t prevBit(const Chunk& c, std::uint32_t pos, bool inclusive) {
+        if (!inclusive && pos-- == 0) return 65536;
+        std::size_t w = pos >> 6;
+        std::uint64_t m = c.words[w] & (~std::uint64_t(0) >> (63 - (pos & 63)));
+        while (m == 0) {
+            if (w == 0) return 65536;
+            m = c.words[--w];
+        }
+        return static_cast<std::uint32_t>(w * 64 + highestBit(m));
+    }
+
+    std::uint32_t valueAt(const RoaringOrder::Cursor& at) const {
+        const Chunk& c = chunks[at.chunk];
+        const std::uint32_t lowBits = c.isBitmap() ? at.pos : c.array[at.pos];
+        return (static_cast<std::uint32_t>(c.key) << 16) | lowBits;
+    }
+
+    /** @brief Move to the next value (the caller guarantees one exists). */
+    void advance(RoaringOrder::Cursor& at) const {
+        const Chunk& c = chunks[at.chunk];
+        if (c.isBitmap()) {
+            at.pos = nextBit(c, at.pos, false);
+            if (at.pos < 65536) return;
+        } else if (++at.pos < c.array.size()) {
+            return;
+        }
+        ++at.chunk;
+        const Chunk& next = chunks[at.chunk];
+        at.pos = next.isBitmap() ? nextBit(next, 0, true) : 0U;
+    }
+
+    /** @brief Move to the previous value (the caller guarantees one exists). */
+    void retreat(RoaringOrder::Cursor& at) const {
+        const Chunk& c = chunks[at.chunk];
+        if (c.isBitmap()) {
+            at.pos = prevBit(c, at.pos, false);
+            if (at.pos < 65536) return;
+        } else if (at.pos-- > 0) {
+            return;
+        }
+        --at.chunk;
+        const Chunk& prev = chunks[at.chunk];
+        at.pos = prev.isBitmap() ? prevBit(prev, 65535, true) : static_cast<std::uint32_t>(prev.array.size() - 1);
+    }
+
+    // ===== Set operations =====
+
+    enum class SetOp { Union, Intersection, Difference };
+
+    /** @brief dst = a op b over one bitmap chunk, 128 bits per instruction where SSE2 exists. */
+    static void combineWords(SetOp op, std::uint64_t* dst, const std::uint64_t* a, const std::uint64_t* b) {
+#if defined(__SSE2__)
+        for (std::size_t i = 0; i < kWords; i += 2) {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            const __m128i r = op == SetOp::Union        ? _mm_or_si128(va, vb)
+                            : op == SetOp::Intersection ? _mm_and_si128(va, vb)
+                                                        : _mm_andnot_si128(vb, va);   /** a & ~b */
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), r);
+        }
+#else
+        for (std::size_t i = 0; i < kWords; ++i) {
+            dst[i] = op == SetOp::Union ? (a[i] | b[i]) : op == SetOp::Intersection ? (a[i] & b[i]) : (a[i] & ~b[i]);
+        }
+#endif
+    }
+
+    /**
+     * @brief Combine two chunks with the same key.
+     * Two arrays are merged as sorted sequences; anything involving a bitmap goes through
+     * word operations. The result takes the form that suits its cardinality.
+     */
+    static Chunk combine(SetOp op, const Chunk& x, const Chunk& y) {
+        Chunk out;
+        out.key = x.key;
+        if (!x.isBitmap() && !y.isBitmap()) {
+            auto sink = std::back_inserter(out.array);
+            if (op == SetOp::Union) std::set_union(x.array.begin(), x.array.end(), y.array.begin(), y.array.end(), sink);
+            else if (op == SetOp::Intersection) std::set_intersection(x.array.begin(), x.array.end(), y.array.begin(), y.array.end(), sink);
+            else std::set_difference(x.array.begin(), x.array.end(), y.array.begin(), y.array.end(), sink);
+            out.cardinality = out.array.size();
+            if (out.cardinality > kArrayMax) out.toBitmap();
+            return out;
+        }
+        std::vector<std::uint64_t> scratchA, scratchB;             /** Used only for array chunks. */
+        const std::vector<std::uint64_t>& a = x.bitmapWords(scratchA);
+        const std::vector<std::uint64_t>& b = y.bitmapWords(scratchB);
+        out.words.resize(kWords);
+        combineWords(op, out.words.data(), a.data(), b.data());
+        for (std::uint64_t w : out.words) out.cardinality += popcount(w);
+        if (out.cardinality <= kArrayMax) out.toArray();
+        return out;
+    }
+
+    /** @brief Merge the chunk lists of two containers by key. */
+    static RoaringContainer apply(SetOp op, const RoaringContainer& a, const RoaringContainer& b) {
+        RoaringContainer out;
+        std::size_t i = 0, j = 0;
+        auto keep = [&out](Chunk c) {
+            if (c.cardinality == 0) return;
+            out.count += c.cardinality;
+            out.chunks.push_back(std::move(c));
+        };
+        while (i < a.chunks.size() || j < b.chunks.size()) {
+            const bool hasA = i < a.chunks.size();
+            const bool hasB = j < b.chunks.size();
+            if (hasA && (!hasB || a.chunks[i].key < b.chunks[j].key)) {
+                if (op != SetOp::Intersection) keep(a.chunks[i]);
+                ++i;
+            } else if (hasB && (!hasA || b.chunks[j].key < a.chunks[i].key)) {
+                if (op == SetOp::Union) keep(b.chunks[j]);
+                ++j;
+            } else {
+                keep(combine(op, a.chunks[i++], b.chunks[j++]));
+            }
+        }
+        return out;
+    }
+
+public:
+    RoaringContainer() = default;
+
+    /**
+     * @brief Build the set of values held by a MyContainer of integers (duplicates collapse).
+     * @throws std::out_of_range if a value is negative or does not fit in 32 bits.
+     */
+    template <typename U>
+    explicit RoaringContainer(const MyContainer<U>& c) {
+        static_assert(std::is_integral_v<U>, "RoaringContainer holds integers");
+        for (const U& v : c.getData()) {
+            bool fits = true;
+            if constexpr (std::is_signed_v<U>) fits = v >= 0;
+            if constexpr (sizeof(U) > sizeof(std::uint32_t)) {
+                fits = fits && static_cast<std::make_unsigned_t<U>>(v) <= UINT32_MAX;
+            }
+            if (!fits) throw std::out_of_range("Value does not fit in a 32-bit unsigned set");
+            addElement(static_cast<std::uint32_t>(v));
+        }
+    }
+
+    /**
+     * @brief Insert a value (no-op if already present).
+     * Complexity: binary search among chunk keys, then O(1) in a bitmap chunk, or a binary search
+     *             plus a shift of up to 4095 lows in an array chunk (a new chunk shifts the keys).
+     */
+    void addElement(std::uint32_t value) {
+        const std::size_t i = chunkIndex(high(value));
+        if (i == chunks.size() || chunks[i].key != high(value)) {
+            Chunk c;
+            c.key = high(value);
+            chunks.insert(chunks.begin() + static_cast<std::ptrdiff_t>(i), std::move(c));
+        }
+        Chunk& c = chunks[i];
+        const std::uint16_t lowBits = low(value);
+        if (c.isBitmap()) {
+            std::uint64_t& w = c.words[lowBits >> 6];
+            const std::uint64_t bit = std::uint64_t(1) << (lowBits & 63);
+            if (w & bit) return;
+            w |= bit;
+        } else {
+            auto pos = std::lower_bound(c.array.begin(), c.array.end(), lowBits);
+            if (pos != c.array.end() && *pos == lowBits) return;
+            c.array.insert(pos, lowBits);
+        }
+        ++c.cardinality;
+        ++count;
+        if (!c.isBitmap() && c.cardinality > kArrayMax) c.toBitmap();
+    }
+
+    /**
+     * @brief Remove a value.
+     * @throws std::runtime_error if the value does not exist in the container.
+     * Complexity: binary search among chunk keys, then an O(1) bit clear in a bitmap chunk, or
+     *             a binary search plus a shift of up to 4095 lows (8 KiB memmove) in an array
+     *             chunk; not O(1). Emptying a chunk shifts the chunk list. A bitmap chunk returns
+     *             to array form only once it falls to half the array limit, so add/remove at the
+     *             boundary cannot thrash.
+     */
+    void removeElement(std::uint32_t value) {
+        const std::size_t i = chunkIndex(high(value));
+        if (i == chunks.size() || chunks[i].key != high(value) || !chunks[i].test(low(value))) {
+            throw std::runtime_error("This element does not exist in the container");
+        }
+        Chunk& c = chunks[i];
+        const std::uint16_t lowBits = low(value);
+        if (c.isBitmap()) c.words[lowBits >> 6] &= ~(std::uint64_t(1) << (lowBits & 63));
+        else c.array.erase(std::lower_bound(c.array.begin(), c.array.end(), lowBits));
+        --c.cardinality;
+        --count;
+        if (c.cardinality == 0) chunks.erase(chunks.begin() + static_cast<std::ptrdiff_t>(i));
+        else if (c.isBitmap() && c.cardinality <= kArrayMax / 2) c.toArray();
+    }
+
+    /** @return true if `value` is in the set. Bounded by one chunk. */
+    bool contains(std::uint32_t value) const {
+        const Chunk* c = findChunk(high(value));
+        return c && c->test(low(value));
+    }
+
+    /** @return Number of distinct values. */
+    std::size_t size() const { return count; }
+
+    /** @return Number of chunks in bitmap form (for tests and tuning). */
+    std::size_t bitmapChunks() const {
+        return static_cast<std::size_t>(std::count_if(chunks.begin(), chunks.end(), [](const Chunk& c) { return c.isBitmap(); }));
+    }
+
+    /**
+     * @brief Smallest / largest value.
+     * @throws std::runtime_error if the container is empty.
+     */
+    std::uint32_t min() const {
+        if (count == 0) throw std::runtime_error("The container is empty");
+        return valueAt(firstCursor());
+    }
+    std::uint32_t max() const {
+        if (count == 0) throw std::runtime_error("The container is empty");
+        return valueAt(lastCursor());
+    }
+
+    /** @return Values in `a` or `b` / in both / in `a` but not `b`. */
+    friend RoaringContainer operator|(const RoaringContainer& a, const RoaringContainer& b) { return apply(SetOp::Union, a, b); }
+    friend RoaringContainer operator&(const RoaringContainer& a, const RoaringContainer& b) { return apply(SetOp::Intersection, a, b); }
+    friend RoaringContainer operator-(const RoaringContainer& a, const RoaringContainer& b) { return apply(SetOp::Difference, a, b); }
+
+    // ===== Iterator entry points (live views over the bits, invalidated by mutation) =====
+
+    /** @return begin/end for ascending traversal. */
+    RoaringOrder begin_ascending_order() const { return make(RoaringMode::Ascending, 0); }
+    RoaringOrder end_ascending_order()   const { return make(RoaringMode::Ascending, count); }
+
+    /** @return begin/end for descending traversal. */
+    RoaringOrder begin_descending_order() const { return make(RoaringMode::Descending, 0); }
+    RoaringOrder end_descending_order()   const { return make(RoaringMode::Descending, count); }
+
+    /** @return begin/end for side-cross traversal (smallest, largest, next smallest, ...). */
+    RoaringOrder begin_side_cross_order() const { return make(RoaringMode::SideCross, 0); }
+    RoaringOrder end_side_cross_order()   const { return make(RoaringMode::SideCross, count); }
+
+    /** @brief Print the values in ascending order as "x y z \n". */
+    friend std::ostream& operator<<(std::ostream& os, const RoaringContainer& c) {
+        for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) os << *it << ' ';
+        os << std::endl;
+        return os;
+    }
+
+private:
+    RoaringOrder make(RoaringMode mode, std::size_t idx) const {
+        return RoaringOrder(this, firstCursor(), lastCursor(), idx, count, mode);
+    }
+};
+
+inline std::uint32_t RoaringOrder::operator*() const {
+    if (idx >= n) throw std::out_of_range("Iterator is out of range");
+    return owner->valueAt(usesFront() ? front : back);
+}
+
+inline RoaringOrder& RoaringOrder::operator++() {
+    const bool fromFront = usesFront();
+    if (++idx < n) {                                 /** Never step past the last value. */
+        if (fromFront) owner->advance(front);
+        else owner->retreat(back);
+    }
+    return *this;
+}
+
+}
@@ -0,0 +1,288 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <atomic>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <new>
+#include <chrono>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ex4 {
+
+template <typename T> class MyContainer;
+
+/**
+ * @class OffsetPtr
+ * @brief Pointer stored as a byte distance from its own address.
+ *
+ * Overview:
+ *  - A shared memory segment is mapped at a different address in every process,
+ *    so raw pointers stored inside it are meaningless to the other processes.
+ *  - An offset relative to `this` stays valid as long as the pointer and its target
+ *    live in the same mapping.
+ *  - Copying would silently re-base the offset, so copy/assignment are disabled.
+ */
+template <typename T>
+class OffsetPtr {
+    std::ptrdiff_t off;   /** Distance in bytes from `this` to the target (0 means null). */
+
+public:
+    OffsetPtr() : off(0) {}
+    OffsetPtr(const OffsetPtr&) = delete;
+    OffsetPtr& operator=(const OffsetPtr&) = delete;
+
+    /**
+     * @brief Point at `p` (must live in the same mapping as this object).
+     * @param p Target address, or nullptr.
+     */
+    void set(const T* p) {
+        off = p ? reinterpret_cast<const char*>(p) - reinterpret_cast<const char*>(this) : 0;
+    }
+
+    /** @return The target address in the current process, or nullptr. */
+    const T* get() const {
+        return off ? reinterpret_cast<const T*>(reinterpret_cast<const char*>(this) + off) : nullptr;
+    }
+};
+
+/**
+ * @class SharedMemoryContainer
+ * @brief MyContainer backend placed in a POSIX shared memory segment (one writer, many readers).
+ *
+ * Overview:
+ *  - The writer process calls `create()` and then `publish()` with a MyContainer; the segment
+ *    receives the insertion-order data and an ascending copy, both addressed through OffsetPtr.
+ *  - Reader processes call `open()` and traverse the segment in place through plain
+ *    `const T*` ranges: no copy is made on the reader side.
+ *  - Publishing is guarded by a seqlock (`generation` is odd while a publish is in progress).
+ *    A reader records `generation()` before traversing and calls `validate()` afterwards;
+ *    if validation fails the traversal raced with a publish and should be repeated.
+ *  - If the writer dies in the middle of `publish()`, the generation stays odd forever.
+ *    `generation()` then throws after its timeout and `tryGeneration()` keeps returning false
+ *    instead of spinning; readers should treat the segment as abandoned and reopen it once a
+ *    writer has called `create()` again.
+ *
+ * Restrictions:
+ *  - T must be trivially copyable (the bytes are shared as-is between processes).
+ *  - Capacity is fixed at `create()` time.
+ */
+template <typename T>
+class SharedMemoryContainer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SharedMemoryContainer requires a trivially copyable element type");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "Cross-process seqlock requires lock-free 64-bit atomics");
+
+    /** Segment header, placed at offset 0 of the mapping. */
+    struct Header {
+        std::uint64_t magic;                     /** Identifies an initialized segment. */
+        std::uint64_t elemSize;                  /** sizeof(T) used by the writer. */
+        std::uint64_t capacity;                  /** Maximum number of elements. */
+        std::atomic<std::uint64_t> generation;   /** Seqlock counter (odd = publish in progress). */
+        std::uint64_t count;                     /** Number of published elements. */
+        OffsetPtr<T> data;                       /** Insertion-order region. */
+        OffsetPtr<T> sorted;                     /** Ascending-order region. */
+    };
+
+    static constexpr std::uint64_t kMagic = 0x6578344d79436e74ULL; /** "ex4MyCnt". */
+
+    std::string name;        /** Segment name (as passed to shm_open). */
+    void* base;              /** Start of the mapping in this process. */
+    std::size_t bytes;       /** Mapping length. */
+    bool writable;           /** True for the writer mapping. */
+
+    SharedMemoryContainer(std::string n, void* b, std::size_t len, bool w)
+        : name(std::move(n)), base(b), bytes(len), writable(w) {}
+
+    Header* header() const { return static_cast<Header*>(base); }
+
+    /** @return Byte size of a segment able to hold `capacity` elements. */
+    static std::size_t segmentSize(std::size_t capacity) {
+        return regionOffset() + 2 * capacity * sizeof(T);
+    }
+
+    /** @return Offset of the first data region, rounded up to T's alignment. */
+    static constexpr std::size_t regionOffset() {
+        return (sizeof(Header) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+public:
+    /** Default longest wait in `generation()` for a publish in progress to finish. */
+    static constexpr std::chrono::milliseconds kPublishTimeout{1000};
+
+    /**
+     * @brief Create (or truncate) a segment and map it for writing.
+     * @param segmentName POSIX shm name, e.g. "/my_container".
+     * @param capacity    Maximum number of elements that can be published.
+     * @throws std::runtime_error if the segment cannot be created or mapped.
+     */
+    static SharedMemoryContainer create(const std::string& segmentName, std::size_t capacity) {
+        int fd = ::shm_open(segmentName.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+        if (fd < 0) throw std::runtime_error("Failed to create shared memory segment");
+        const std::size_t len = segmentSize(capacity);
+        if (::ftruncate(fd, static_cast<off_t>(len)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to size shared memory segment");
+        }
+        void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);                                           /** The mapping keeps the segment alive. */
+        if (p == MAP_FAILED) throw std::runtime_error("Failed to map shared memory segment");
+
+        Header* h = new (p) Header();                          /** Construct header in place. */
+        h->elemSize = sizeof(T);
+        h->capacity = capacity;
+        h->count = 0;
+        h->generation.store(0, std::memory_order_relaxed);
+        T* first = reinterpret_cast<T*>(static_cast<char*>(p) + regionOffset());
+        h->data.set(first);
+        h->sorted.set(first + capacity);
+        std::atomic_thread_fence(std::memory_order_release);
+        h->magic = kMagic;                                     /** Mark the segment as initialized last. */
+        return SharedMemoryContainer(segmentName, p, len, true);
+    }
+
+    /**
+     * @brief Map an existing segment read-only (reader side).
+     * @param segmentName POSIX shm name used by the writer.
+     * @throws std::runtime_error if the segment is missing or was written for another element type.
+     */
+    static SharedMemoryContainer open(const std::string& segmentName) {
+        int fd = ::shm_open(segmentName.c_str(), O_RDONLY, 0);
+        if (fd < 0) throw std::runtime_error("Shared memory segment does not exist");
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Header)) {
+            ::close(fd);
+            throw std::runtime_error("Shared memory segment is not initialized");
+        }
+        const std::size_t len = static_cast<std::size_t>(st.st_size);
+        void* p = ::mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("Failed to map shared memory segment");
+
+        const Header* h = static_cast<const Header*>(p);
+        if (h->magic != kMagic || h->elemSize != sizeof(T) || segmentSize(h->capacity) > len) {
+            ::munmap(p, len);
+            throw std::runtime_error("Shared memory segment has an incompatible layout");
+        }
+        return SharedMemoryContainer(segmentName, p, len, false);
+    }
+
+    /**
+     * @brief Remove a segment name from the system (existing mappings stay valid).
+     * @param segmentName POSIX shm name.
+     */
+    static void unlink(const std::string& segmentName) { ::shm_unlink(segmentName.c_str()); }
+
+    SharedMemoryContainer(const SharedMemoryContainer&) = delete;
+    SharedMemoryContainer& operator=(const SharedMemoryContainer&) = delete;
+
+    SharedMemoryContainer(SharedMemoryContainer&& other) noexcept
+        : name(std::move(other.name)), base(other.base), bytes(other.bytes), writable(other.writable) {
+        other.base = nullptr;
+    }
+
+    ~SharedMemoryContainer() {
+        if (base) ::munmap(base, bytes);
+    }
+
+    /**
+     * @brief Publish the contents of a MyContainer into the segment (writer only).
+     * @param c Source container.
+     * @throws std::runtime_error if this is a reader mapping or `c` exceeds the capacity.
+     *
+     * Complexity: O(n log n) for the ascending region; readers never sort.
+     */
+    void publish(const MyContainer<T>& c) {
+        if (!writable) throw std::runtime_error("Cannot publish through a read-only mapping");
+        const std::vector<T>& src = c.getData();
+        Header* h = header();
+        if (src.size() > h->capacity) throw std::runtime_error("Shared memory segment capacity exceeded");
+
+        T* data = const_cast<T*>(h->data.get());
+        T* sorted = const_cast<T*>(h->sorted.get());
+        const std::uint64_t g = h->generation.load(std::memory_order_relaxed);
+        h->generation.store(g + 1, std::memory_order_relaxed);      /** Odd: publish in progress. */
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::copy(src.begin(), src.end(), data);                     /** Insertion order region. */
+        std::copy(src.begin(), src.end(), sorted);                   /** Ascending region. */
+        std::sort(sorted, sorted + src.size());
+        h->count = src.size();
+
+        h->generation.store(g + 2, std::memory_order_release);      /** Even: publish complete. */
+    }
+
+    /**
+     * @brief Read the seqlock generation without waiting.
+     * @param g Receives the generation; on success an even value to pass to `validate()`.
+     * @return false if a publish is in progress (or the writer died during one).
+     */
+    bool tryGeneration(std::uint64_t& g) const {
+        g = header()->generation.load(std::memory_order_acquire);
+        return (g & 1U) == 0;
+    }
+
+    /**
+     * @brief Current seqlock generation; waits (yielding the CPU) while a publish is in progress.
+     * @param timeout Longest wait for the writer to finish.
+     * @return An even generation value to pass to `validate()`.
+     * @throws std::runtime_error if a publish is still in progress after `timeout`: the writer
+     *         is stalled or died inside publish().
+     */
+    std::uint64_t generation(std::chrono::milliseconds timeout = kPublishTimeout) const {
+        std::uint64_t g;
+        if (tryGeneration(g)) return g;
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!tryGeneration(g)) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                throw std::runtime_error("Shared memory writer did not finish publishing");
+            }
+            std::this_thread::yield();
+        }
+        return g;
+    }
+
+    /**
+     * @brief Check that no publish happened since `generation()` returned `g`.
+     * @return true if everything read in between is consistent.
+     */
+    bool validate(std::uint64_t g) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return header()->generation.load(std::memory_order_relaxed) == g;
+    }
+
+    /** @return Number of published elements. */
+    std::size_t size() const { return static_cast<std::size_t>(header()->count); }
+
+    /** @return Maximum number of elements the segment can hold. */
+    std::size_t capacity() const { return static_cast<std::size_t>(header()->capacity); }
+
+    // ===== Zero-copy traversal ranges over the mapped segment =====
+
+    /** @return begin/end for insertion order traversal. */
+    const T* begin_order() const { return header()->data.get(); }
+    const T* end_order()   const { return header()->data.get() + size(); }
+
+    /** @return begin/end for ascending sorted traversal. */
+    const T* begin_ascending_order() const { return header()->sorted.get(); }
+    const T* end_ascending_order()   const { return header()->sorted.get() + size(); }
+
+    /** @return begin/end for descending sorted traversal (ascending region read backwards). */
+    std::reverse_iterator<const T*> begin_descending_order() const {
+        return std::reverse_iterator<const T*>(end_ascending_order());
+    }
+    std::reverse_iterator<const T*> end_descending_order() const {
+        return std::reverse_iterator<const T*>(begin_ascending_order());
+    }
+};
+
+}
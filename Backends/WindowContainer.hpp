@@ -0,0 +1,227 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <cstddef>
+#include "../Index/IndexableSkipList.hpp"
+
+namespace ex4 {
+
+template <typename T> class WindowContainer;
+
+/**
+ * @class RingOrder
+ * @brief Iterator over the window of a WindowContainer in insertion (or reverse insertion) order.
+ *
+ * Overview:
+ *  - Reads the ring buffer in place: logical position `idx` maps to slot (head + idx) % capacity.
+ *  - No copy is made, so the iterator is invalidated by any mutation of the container.
+ */
+template <typename T>
+class RingOrder {
+    const WindowContainer<T>* owner;  /** Container whose ring is traversed. */
+    std::size_t idx;                  /** Logical position (0..size()). */
+    bool reverse;                     /** true: newest element first. */
+
+public:
+    RingOrder(const WindowContainer<T>* c, std::size_t i, bool rev)
+        : owner(c), idx(i), reverse(rev) {}
+
+    /**
+     * @brief Dereference operator (read-only).
+     * @throws std::out_of_range at the end position.
+     */
+    const T& operator*() const {
+        const std::size_t n = owner->size();
+        if (idx >= n) throw std::out_of_range("Iterator is out of range");
+        return owner->slot(reverse ? n - 1 - idx : idx);
+    }
+    const T* operator->() const { return &**this; }
+
+    RingOrder& operator++() { ++idx; return *this; }
+    RingOrder operator++(int) {
+        RingOrder tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const RingOrder& other) const {
+        return owner == other.owner && idx == other.idx && reverse == other.reverse;
+    }
+    bool operator!=(const RingOrder& other) const { return !(*this == other); }
+};
+
+/**
+ * @class SkipListOrder
+ * @brief Iterator over the skip list of a WindowContainer in ascending (or descending) order.
+ *
+ * Walks level-0 links (`next` forwards, `prev` backwards): O(1) per step, no copy.
+ * Invalidated by any mutation of the container.
+ */
+template <typename T>
+class SkipListOrder {
+    using Node = typename IndexableSkipList<T>::Node;
+    const Node* node;   /** Current node (nullptr = end). */
+    bool descending;    /** true: follow `prev` links. */
+
+public:
+    SkipListOrder(const Node* n, bool desc) : node(n), descending(desc) {}
+
+    /**
+     * @brief Dereference operator (read-only).
+     * @throws std::out_of_range at the end position.
+     */
+    const T& operator*() const {
+        if (!node) throw std::out_of_range("Iterator is out of range");
+        return node->value;
+    }
+    const T* operator->() const { return &**this; }
+
+    SkipListOrder& operator++() {
+        node = descending ? node->prev : node->next[0];
+        return *this;
+    }
+    SkipListOrder operator++(int) {
+        SkipListOrder tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const SkipListOrder& other) const { return node == other.node; }
+    bool operator!=(const SkipListOrder& other) const { return !(*this == other); }
+};
+
+/**
+ * @class WindowContainer
+ * @brief Bounded sliding-window container: keeps only the last `capacity` inserted values.
+ *
+ * Overview:
+ *  - Insertion order lives in a fixed ring buffer; `addElement` on a full window overwrites
+ *    (evicts) the oldest value in O(1) plus the index update.
+ *  - Sorted orders come from an IndexableSkipList maintained on every add/evict, so
+ *    `min()`, `max()` are O(1) and `median()` / `at_rank()` are O(log N).
+ *  - Iterators read the live structures (no snapshot), unlike MyContainer's snapshot iterators.
+ */
+template <typename T>
+class WindowContainer {
+    std::vector<T> ring;            /** Ring storage (grows up to `cap`, then reused). */
+    std::size_t cap;                /** Window size N. */
+    std::size_t head = 0;           /** Slot of the oldest element. */
+    IndexableSkipList<T> sorted;    /** Same elements, ordered. */
+
+    friend class RingOrder<T>;
+
+    /** @return The i-th oldest element in the window. */
+    const T& slot(std::size_t i) const { return ring[(head + i) % ring.size()]; }
+
+public:
+    /**
+     * @brief Create an empty window.
+     * @param capacity Maximum number of retained values.
+     * @throws std::invalid_argument if capacity is zero.
+     */
+    explicit WindowContainer(std::size_t capacity) : cap(capacity) {
+        if (capacity == 0) throw std::invalid_argument("Window capacity must be positive");
+        ring.reserve(capacity);
+    }
+
+    /**
+     * @brief Append a value, evicting the oldest one if the window is full.
+     * Complexity: O(log N) expected.
+     */
+    void addElement(const T& value) {
+        if (ring.size() < cap) {
+            ring.push_back(value);
+        } else {
+            sorted.eraseFirst(ring[head]);         /** The oldest of its equals is the evicted one. */
+            ring[head] = value;
+            head = (head + 1) % cap;
+        }
+        sorted.insert(value);
+    }
+
+    /**
+     * @brief Remove all occurrences of a value from the window.
+     * @throws std::runtime_error if the value does not exist in the window.
+     * Complexity: O(N log N) (the ring is compacted and the index rebuilt).
+     */
+    void removeElement(const T& value) {
+        std::vector<T> kept;
+        kept.reserve(ring.size());
+        for (std::size_t i = 0; i < ring.size(); ++i) {
+            if (!(slot(i) == value)) kept.push_back(slot(i));
+        }
+        if (kept.size() == ring.size()) {
+            throw std::runtime_error("This element does not exist in the container");
+        }
+        ring.swap(kept);
+        head = 0;
+        sorted.clear();
+        for (const T& v : ring) sorted.insert(v);
+    }
+
+    /** @return Number of values currently in the window (at most capacity()). */
+    std::size_t size() const { return ring.size(); }
+
+    /** @return Window size N. */
+    std::size_t capacity() const { return cap; }
+
+    /**
+     * @brief Smallest / largest value in the window.
+     * @throws std::runtime_error if the window is empty.
+     * Complexity: O(1).
+     */
+    const T& min() const {
+        if (sorted.empty()) throw std::runtime_error("The container is empty");
+        return sorted.first()->value;
+    }
+    const T& max() const {
+        if (sorted.empty()) throw std::runtime_error("The container is empty");
+        return sorted.last()->value;
+    }
+
+    /**
+     * @brief Lower median (element of rank (size-1)/2).
+     * @throws std::runtime_error if the window is empty.
+     * Complexity: O(log N) expected.
+     */
+    const T& median() const {
+        if (sorted.empty()) throw std::runtime_error("The container is empty");
+        return sorted.at((sorted.size() - 1) / 2);
+    }
+
+    /**
+     * @brief k-th smallest value (0-based).
+     * @throws std::out_of_range if k >= size().
+     */
+    const T& at_rank(std::size_t k) const { return sorted.at(k); }
+
+    // ===== Iterator entry points (live views, invalidated by mutation) =====
+
+    /** @return begin/end for insertion order traversal (oldest first). */
+    RingOrder<T> begin_order() const { return RingOrder<T>(this, 0, false); }
+    RingOrder<T> end_order()   const { return RingOrder<T>(this, size(), false); }
+
+    /** @return begin/end for reverse insertion order traversal (newest first). */
+    RingOrder<T> begin_reverse_order() const { return RingOrder<T>(this, 0, true); }
+    RingOrder<T> end_reverse_order()   const { return RingOrder<T>(this, size(), true); }
+
+    /** @return begin/end for ascending sorted traversal. */
+    SkipListOrder<T> begin_ascending_order() const { return SkipListOrder<T>(sorted.first(), false); }
+    SkipListOrder<T> end_ascending_order()   const { return SkipListOrder<T>(nullptr, false); }
+
+    /** @return begin/end for descending sorted traversal. */
+    SkipListOrder<T> begin_descending_order() const { return SkipListOrder<T>(sorted.last(), true); }
+    SkipListOrder<T> end_descending_order()   const { return SkipListOrder<T>(nullptr, true); }
+
+    /** @brief Print the window in insertion order as "x y z \n". */
+    friend std::ostream& operator<<(std::ostream& os, const WindowContainer& c) {
+        for (std::size_t i = 0; i < c.size(); ++i) os << c.slot(i) << ' ';
+        os << std::endl;
+        return os;
+    }
+};
+
+}
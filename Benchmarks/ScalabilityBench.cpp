@@ -0,0 +1,237 @@
+/**
+ * Scalability benchmark driver for MyContainer.
+ *
+ * Sweeps container size (powers of ten from 10 up to --max-size), value distribution
+ * (sorted, reverse_sorted, random, few_unique, zipf), element type (int, double,
+ * std::string, 64-byte struct) and workload, and prints one CSV row per measurement:
+ *
+ *   type,distribution,size,workload,order,iterations,ns_total,ns_per_item
+ *
+ * Workloads:
+ *  - traverse_cold : build the begin/end pair right after a mutation and walk it.
+ *  - traverse_warm : same, with the container unchanged since the previous walk.
+ *  - read_heavy / mixed / write_heavy : 90/50/10 % traversals, the rest add/remove
+ *    operations; `order` is "all" and ns_per_item is per operation.
+ *
+ * Usage: ScalabilityBench [--max-size N] [--ops N] [--seed N] [--out file.csv]
+ * Defaults keep a full sweep to a few minutes; pass --max-size 100000000 for the full range.
+ */
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include "../MyContainer.hpp"
+
+using namespace ex4;
+
+namespace {
+
+/** 64-byte element: ordered by `key`, the rest is payload that has to be moved around. */
+struct Payload64 {
+    std::uint64_t key;
+    char pad[56];
+    bool operator==(const Payload64& o) const { return key == o.key; }
+    bool operator<(const Payload64& o) const { return key < o.key; }
+    bool operator>(const Payload64& o) const { return key > o.key; }
+    friend std::ostream& operator<<(std::ostream& os, const Payload64& p) { return os << p.key; }
+};
+static_assert(sizeof(Payload64) == 64, "Payload64 must be exactly 64 bytes");
+
+/** Conversion from a generated integer key to each benchmarked element type. */
+template <typename T> T fromKey(std::uint64_t k);
+template <> int fromKey<int>(std::uint64_t k) { return static_cast<int>(k); }
+template <> double fromKey<double>(std::uint64_t k) { return static_cast<double>(k) + 0.5; }
+template <> std::string fromKey<std::string>(std::uint64_t k) {
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "k%015llu", static_cast<unsigned long long>(k)); /** Zero-padded: lexicographic == numeric. */
+    return buf;
+}
+template <> Payload64 fromKey<Payload64>(std::uint64_t k) {
+    Payload64 p;
+    p.key = k;
+    std::memset(p.pad, static_cast<int>(k & 0xff), sizeof(p.pad));
+    return p;
+}
+
+/** Fold an element into a checksum so traversals cannot be optimized away. */
+inline std::uint64_t touch(int v) { return static_cast<std::uint64_t>(v); }
+inline std::uint64_t touch(double v) { return static_cast<std::uint64_t>(v); }
+inline std::uint64_t touch(const std::string& v) { return v.size() + static_cast<unsigned char>(v.back()); }
+inline std::uint64_t touch(const Payload64& v) { return v.key + static_cast<unsigned char>(v.pad[0]); }
+
+volatile std::uint64_t g_sink = 0;
+
+/** Generate `n` keys following a named distribution. */
+std::vector<std::uint64_t> makeKeys(const std::string& dist, std::size_t n, std::mt19937_64& rng) {
+    std::vector<std::uint64_t> keys(n);
+    if (dist == "sorted") {
+        for (std::size_t i = 0; i < n; ++i) keys[i] = i;
+    } else if (dist == "reverse_sorted") {
+        for (std::size_t i = 0; i < n; ++i) keys[i] = n - i;
+    } else if (dist == "random") {
+        std::uniform_int_distribution<std::uint64_t> u(0, n * 4);
+        for (auto& k : keys) k = u(rng);
+    } else if (dist == "few_unique") {
+        std::uniform_int_distribution<std::uint64_t> u(0, 15);
+        for (auto& k : keys) k = u(rng);
+    } else if (dist == "zipf") {
+        const std::size_t ranks = std::min<std::size_t>(n, 10000);      /** Skewed over at most 10^4 values. */
+        std::vector<double> cdf(ranks);
+        double acc = 0;
+        for (std::size_t r = 0; r < ranks; ++r) cdf[r] = (acc += 1.0 / std::pow(static_cast<double>(r + 1), 1.1));
+        std::uniform_real_distribution<double> u(0, acc);
+        for (auto& k : keys) {
+            k = static_cast<std::uint64_t>(std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin());
+        }
+    }
+    return keys;
+}
+
+struct Config {
+    std::size_t maxSize = 100000;
+    std::size_t ops = 20;
+    std::uint64_t seed = 42;
+};
+
+class CsvWriter {
+    std::ostream& os;
+
+public:
+    explicit CsvWriter(std::ostream& out) : os(out) {
+        os << "type,distribution,size,workload,order,iterations,ns_total,ns_per_item\n";
+    }
+    void row(const char* type, const std::string& dist, std::size_t size, const char* workload,
+             const char* order, std::size_t iterations, std::uint64_t ns, std::size_t items) {
+        os << type << ',' << dist << ',' << size << ',' << workload << ',' << order << ','
+           << iterations << ',' << ns << ',' << std::fixed << std::setprecision(3)
+           << (items ? static_cast<double>(ns) / static_cast<double>(items) : 0.0) << '\n';
+        os.flush();
+    }
+};
+
+template <typename F>
+std::uint64_t timeNs(F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - t0).count());
+}
+
+/** Walk one order completely, folding every element into the sink. */
+template <typename It>
+void walk(It begin, It end) {
+    std::uint64_t acc = 0;
+    for (; begin != end; ++begin) acc += touch(*begin);
+    g_sink = g_sink + acc;
+}
+
+template <typename T>
+void traverseOrder(const MyContainer<T>& c, const std::string& order) {
+    if (order == "insertion") walk(c.begin_order(), c.end_order());
+    else if (order == "reverse") walk(c.begin_reverse_order(), c.end_reverse_order());
+    else if (order == "ascending") walk(c.begin_ascending_order(), c.end_ascending_order());
+    else if (order == "descending") walk(c.begin_descending_order(), c.end_descending_order());
+    else if (order == "side_cross") walk(c.begin_side_cross_order(), c.end_side_cross_order());
+    else walk(c.begin_middle_out_order(), c.end_middle_out_order());
+}
+
+const std::vector<std::string> kOrders = {
+    "insertion", "reverse", "ascending", "descending", "side_cross", "middle_out"
+};
+
+template <typename T>
+void benchType(const char* type, const Config& cfg, CsvWriter& csv) {
+    const std::vector<std::string> dists = {"sorted", "reverse_sorted", "random", "few_unique", "zipf"};
+    for (std::size_t n = 10; n <= cfg.maxSize; n *= 10) {
+        for (const auto& dist : dists) {
+            std::mt19937_64 rng(cfg.seed);
+            const std::vector<std::uint64_t> keys = makeKeys(dist, n, rng);
+            MyContainer<T> c;
+            for (auto k : keys) c.addElement(fromKey<T>(k));
+
+            const T sentinel = fromKey<T>(n * 8 - 1);                /** Never produced by makeKeys. */
+            for (const auto& order : kOrders) {
+                c.addElement(sentinel);                              /** Mutate → cold views. */
+                c.removeElement(sentinel);
+                std::uint64_t cold = timeNs([&] { traverseOrder(c, order); });
+                csv.row(type, dist, n, "traverse_cold", order.c_str(), 1, cold, c.size());
+                std::uint64_t warm = timeNs([&] { traverseOrder(c, order); });
+                csv.row(type, dist, n, "traverse_warm", order.c_str(), 1, warm, c.size());
+            }
+
+            const std::pair<const char*, unsigned> mixes[] = {
+                {"read_heavy", 90}, {"mixed", 50}, {"write_heavy", 10}
+            };
+            for (const auto& mix : mixes) {
+                std::mt19937_64 opRng(cfg.seed + 1);
+                std::uniform_int_distribution<unsigned> pct(0, 99);
+                std::uint64_t next = n * 8;                          /** Fresh values outside the key range. */
+                std::vector<T> added;
+                std::uint64_t ns = timeNs([&] {
+                    for (std::size_t op = 0; op < cfg.ops; ++op) {
+                        if (pct(opRng) < mix.second) {
+                            traverseOrder(c, kOrders[op % kOrders.size()]);
+                        } else if (added.empty() || op % 2 == 0) {
+                            added.push_back(fromKey<T>(next++));
+                            c.addElement(added.back());
+                        } else {
+                            c.removeElement(added.back());
+                            added.pop_back();
+                        }
+                    }
+                });
+                csv.row(type, dist, n, mix.first, "all", cfg.ops, ns, cfg.ops);
+                for (const auto& v : added) c.removeElement(v);      /** Restore for the next mix. */
+            }
+        }
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    Config cfg;
+    std::string outPath;
+    const char* usage = " [--max-size N] [--ops N] [--seed N] [--out file.csv]\n";
+    for (int i = 1; i < argc; i += 2) {
+        std::string flag = argv[i];
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for " << flag << '\n' << "Usage: " << argv[0] << usage;
+            return 1;
+        }
+        std::uint64_t value = std::strtoull(argv[i + 1], nullptr, 10);
+        if (flag == "--max-size") cfg.maxSize = value;
+        else if (flag == "--ops") cfg.ops = value;
+        else if (flag == "--seed") cfg.seed = value;
+        else if (flag == "--out") outPath = argv[i + 1];
+        else {
+            std::cerr << "Unknown option " << flag << '\n'
+                      << "Usage: " << argv[0] << usage;
+            return 1;
+        }
+    }
+
+    std::ofstream file;
+    if (!outPath.empty()) {
+        file.open(outPath);
+        if (!file) {
+            std::cerr << "Cannot open " << outPath << '\n';
+            return 1;
+        }
+    }
+    CsvWriter csv(outPath.empty() ? std::cout : file);
+    benchType<int>("int", cfg, csv);
+    benchType<double>("double", cfg, csv);
+    benchType<std::string>("string", cfg, csv);
+    benchType<Payload64>("payload64", cfg, csv);
+    return 0;
+}
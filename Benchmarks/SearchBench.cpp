@@ -0,0 +1,130 @@
+/**
+ * Search benchmark: Eytzinger layout vs std::lower_bound on the sorted view.
+ *
+ * For each size (powers of ten from 1000 up to --max-size) a MyContainer<int> is filled with
+ * random values, then the same random queries are answered by:
+ *
+ *  - std_lower_bound : std::lower_bound over the sorted snapshot (cache miss per level).
+ *  - eytzinger       : EytzingerIndex::lowerBound (branchless, prefetching).
+ *  - contains        : MyContainer::contains (the Eytzinger path, plus the hit check).
+ *
+ * and one CSV row is printed per measurement:
+ *
+ *   method,size,queries,ns_total,ns_per_query
+ *
+ * Usage: SearchBench [--max-size N] [--queries N] [--seed N] [--out file.csv]
+ */
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include "../MyContainer.hpp"
+
+using namespace ex4;
+
+namespace {
+
+struct Config {
+    std::size_t maxSize = 10000000;
+    std::size_t queries = 1000000;
+    std::uint64_t seed = 42;
+};
+
+volatile std::uint64_t g_sink = 0;
+
+template <typename F>
+std::uint64_t timeNs(F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - t0).count());
+}
+
+void row(std::ostream& os, const char* method, std::size_t size, std::size_t queries, std::uint64_t ns) {
+    os << method << ',' << size << ',' << queries << ',' << ns << ',' << std::fixed << std::setprecision(3)
+       << static_cast<double>(ns) / static_cast<double>(queries) << '\n';
+    os.flush();
+}
+
+void benchSize(std::size_t n, const Config& cfg, std::ostream& os) {
+    std::mt19937_64 rng(cfg.seed);
+    std::uniform_int_distribution<int> value(0, static_cast<int>(std::min<std::size_t>(n * 4, INT32_MAX)));
+    MyContainer<int> c;
+    c.enableSearchIndex();
+    for (std::size_t i = 0; i < n; ++i) c.addElement(value(rng));
+    std::vector<int> queries(cfg.queries);
+    for (auto& q : queries) q = value(rng);
+
+    const auto sorted = c.sortedSnapshot();
+    const EytzingerIndex<int> layout(*sorted);
+    c.contains(0);                                      /** Warm the container's own search layout. */
+
+    std::uint64_t ns = timeNs([&] {
+        std::uint64_t acc = 0;
+        for (int q : queries) acc += static_cast<std::uint64_t>(std::lower_bound(sorted->begin(), sorted->end(), q) - sorted->begin());
+        g_sink = g_sink + acc;
+    });
+    row(os, "std_lower_bound", n, queries.size(), ns);
+
+    ns = timeNs([&] {
+        std::uint64_t acc = 0;
+        for (int q : queries) acc += layout.lowerBound(q);
+        g_sink = g_sink + acc;
+    });
+    row(os, "eytzinger", n, queries.size(), ns);
+
+    ns = timeNs([&] {
+        std::uint64_t acc = 0;
+        for (int q : queries) acc += c.contains(q);
+        g_sink = g_sink + acc;
+    });
+    row(os, "contains", n, queries.size(), ns);
+}
+
+}
+
+int main(int argc, char** argv) {
+    Config cfg;
+    std::string outPath;
+    const char* usage = " [--max-size N] [--queries N] [--seed N] [--out file.csv]\n";
+    for (int i = 1; i < argc; i += 2) {
+        std::string flag = argv[i];
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for " << flag << '\n' << "Usage: " << argv[0] << usage;
+            return 1;
+        }
+        std::uint64_t value = std::strtoull(argv[i + 1], nullptr, 10);
+        if (flag == "--max-size") cfg.maxSize = value;
+        else if (flag == "--queries") cfg.queries = value;
+        else if (flag == "--seed") cfg.seed = value;
+        else if (flag == "--out") outPath = argv[i + 1];
+        else {
+            std::cerr << "Unknown option " << flag << '\n'
+                      << "Usage: " << argv[0] << usage;
+            return 1;
+        }
+    }
+    if (cfg.queries == 0) {
+        std::cerr << "--queries must be positive\n" << "Usage: " << argv[0] << usage;
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!outPath.empty()) {
+        file.open(outPath);
+        if (!file) {
+            std::cerr << "Cannot open " << outPath << '\n';
+            return 1;
+        }
+    }
+    std::ostream& os = outPath.empty() ? std::cout : file;
+    os << "method,size,queries,ns_total,ns_per_query\n";
+    for (std::size_t n = 1000; n <= cfg.maxSize; n *= 10) benchSize(n, cfg, os);
+    return 0;
+}
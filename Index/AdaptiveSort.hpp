@@ -0,0 +1,278 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "../Instrumentation/Trace.hpp"
+
+namespace ex4 {
+
+/** Sorting strategy picked by `adaptiveSort` for one build of the sorted index. */
+enum class SortStrategy {
+    None,          /** Nothing sorted yet (no index built). */
+    AlreadySorted, /** Input was one ascending run: no work beyond the scan. */
+    Reversed,      /** Input was one strictly descending run: reversed in place. */
+    Insertion,     /** Small input: insertion sort. */
+    RunMerge,      /** Few natural runs: pairwise merging of the runs (TimSort style). */
+    PrefixMerge,   /** Long already-sorted prefix: only the suffix was sorted, then merged in. */
+    Counting,      /** Integers or enums spanning a small [min, max] range: counting sort. */
+    Radix,         /** Arithmetic keys, many runs: LSD radix sort on order-preserving bits. */
+    Comparison     /** General fallback: std::sort (introsort). */
+};
+
+/** @return Lower-case name of a strategy (for logs and benchmarks). */
+inline const char* sortStrategyName(SortStrategy s) {
+    switch (s) {
+        case SortStrategy::None:          return "none";
+        case SortStrategy::AlreadySorted: return "already_sorted";
+        case SortStrategy::Reversed:      return "reversed";
+        case SortStrategy::Insertion:     return "insertion";
+        case SortStrategy::RunMerge:      return "run_merge";
+        case SortStrategy::PrefixMerge:   return "prefix_merge";
+        case SortStrategy::Counting:      return "counting";
+        case SortStrategy::Radix:         return "radix";
+        case SortStrategy::Comparison:    return "comparison";
+    }
+    return "unknown";
+}
+
+/**
+ * @struct RadixKey
+ * @brief Maps an arithmetic value to an unsigned integer with the same ordering.
+ *
+ * Enabled for integral and floating-point types of 1, 2, 4 or 8 bytes. Signed integers
+ * flip the sign bit; floats flip all bits when negative and only the sign bit otherwise.
+ */
+template <typename T, typename Enable = void>
+struct RadixKey {
+    static constexpr bool enabled = false;
+};
+
+template <typename T>
+struct RadixKey<T, std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                                    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)>> {
+    static constexpr bool enabled = true;
+    using UInt = std::conditional_t<sizeof(T) == 1, std::uint8_t,
+                 std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                 std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+    static constexpr UInt kSign = static_cast<UInt>(UInt(1) << (sizeof(T) * 8 - 1));
+
+    static UInt toKey(T v) {
+        UInt bits;
+        std::memcpy(&bits, &v, sizeof(T));
+        if (std::is_floating_point<T>::value) {
+            return (bits & kSign) ? static_cast<UInt>(~bits) : static_cast<UInt>(bits | kSign);
+        }
+        return std::is_signed<T>::value ? static_cast<UInt>(bits ^ kSign) : bits;
+    }
+};
+
+/**
+ * @struct CountingKey
+ * @brief Maps an integer or enum value to an unsigned offset with the same ordering, and back.
+ *
+ * Enabled for integral types other than bool and for enums (through their underlying type).
+ * Signed values flip the sign bit of their 64-bit widening, so `toKey(b) - toKey(a)` is the
+ * distance between two values without overflow.
+ */
+template <typename T, typename Enable = void>
+struct CountingKey {
+    static constexpr bool enabled = false;
+};
+
+template <typename T>
+struct CountingKey<T, std::enable_if_t<(std::is_integral<T>::value && !std::is_same<T, bool>::value) ||
+                                       std::is_enum<T>::value>> {
+    static constexpr bool enabled = true;
+    using Int = typename std::conditional_t<std::is_enum<T>::value, std::underlying_type<T>, std::common_type<T>>::type;
+    static constexpr std::uint64_t kSign = std::uint64_t(1) << 63;
+
+    static std::uint64_t toKey(T v) {
+        if constexpr (std::is_signed<Int>::value) {
+            return static_cast<std::uint64_t>(static_cast<std::int64_t>(static_cast<Int>(v))) ^ kSign;
+        } else {
+            return static_cast<std::uint64_t>(static_cast<Int>(v));
+        }
+    }
+
+    static T fromKey(std::uint64_t k) {
+        if constexpr (std::is_signed<Int>::value) {
+            return static_cast<T>(static_cast<Int>(static_cast<std::int64_t>(k ^ kSign)));
+        } else {
+            return static_cast<T>(static_cast<Int>(k));
+        }
+    }
+};
+
+/**
+ * @brief Counting sort of values known to lie in [lo, lo + slots).
+ * @param first Start of the range to sort ascending in place.
+ * @param n     Number of elements.
+ * @param lo    Smallest value present.
+ * @param slots Number of distinct values the range can hold (size of the count table).
+ *
+ * One pass fills the count table; the output is then expanded straight from the table, so
+ * no comparison is made. Complexity: O(n + slots) time, O(slots) extra space.
+ */
+template <typename T>
+void countingSort(T* first, std::size_t n, T lo, std::size_t slots) {
+    using K = CountingKey<T>;
+    const std::uint64_t base = K::toKey(lo);
+    std::vector<std::size_t> counts(slots, 0);
+    for (std::size_t i = 0; i < n; ++i) ++counts[K::toKey(first[i]) - base];
+    T* out = first;
+    for (std::size_t s = 0; s < slots; ++s) out = std::fill_n(out, counts[s], K::fromKey(base + s));
+}
+
+/**
+ * @brief LSD radix sort (8-bit digits) of arithmetic values.
+ * @param first Start of the range to sort ascending in place.
+ * @param n     Number of elements.
+ *
+ * Digits on which every key agrees are skipped, so narrow value ranges cost fewer passes.
+ * Complexity: O(n * sizeof(T)) time, O(n) extra space.
+ */
+template <typename T>
+void radixSort(T* first, std::size_t n) {
+    using K = RadixKey<T>;
+    std::vector<T> buf(n);
+    T* src = first;
+    T* dst = buf.data();
+    for (unsigned shift = 0; shift < sizeof(T) * 8; shift += 8) {
+        std::size_t counts[256] = {};
+        for (std::size_t i = 0; i < n; ++i) ++counts[(K::toKey(src[i]) >> shift) & 0xff];
+        if (counts[(K::toKey(src[0]) >> shift) & 0xff] == n) continue;   /** Digit is constant: skip pass. */
+        std::size_t offset = 0;
+        for (std::size_t& c : counts) { std::size_t t = c; c = offset; offset += t; }
+        for (std::size_t i = 0; i < n; ++i) dst[counts[(K::toKey(src[i]) >> shift) & 0xff]++] = src[i];
+        std::swap(src, dst);
+    }
+    if (src != first) std::copy(src, src + n, first);
+}
+
+/**
+ * @brief Sort ascending, choosing a strategy from the presortedness of the input.
+ * @param first  Start of the range to sort in place.
+ * @param last   One past the end of the range.
+ * @param bounds Known {min, max} of the range, if the caller tracks them (computed otherwise).
+ * @return The strategy that was used.
+ *
+ * Steps:
+ *  1) Inputs of up to 32 elements use insertion sort.
+ *  2) One O(n) scan splits the input into natural runs (TimSort style): maximal
+ *     non-descending runs, or strictly descending runs which are reversed in place
+ *     (strictness keeps equal elements in their original relative order).
+ *  3) A single run means the input is already sorted (or was reversed).
+ *  4) Up to 64 runs are merged pairwise: O(n log runs).
+ *  5) Otherwise integers and enums whose [min, max] range has fewer values than
+ *     max(n, 256) use counting sort (O(n + range)); other arithmetic types of at least
+ *     256 elements use radix sort, and everything else std::sort.
+ */
+template <typename T>
+SortStrategy adaptiveSort(T* first, T* last, const std::optional<std::pair<T, T>>& bounds = std::nullopt) {
+    EX4_TRACE_SPAN("adaptiveSort");
+    T* v = first;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < 2) return SortStrategy::AlreadySorted;
+    if (n <= 32) {
+        for (std::size_t i = 1; i < n; ++i) {
+            T x = std::move(v[i]);
+            std::size_t j = i;
+            for (; j > 0 && x < v[j - 1]; --j) v[j] = std::move(v[j - 1]);
+            v[j] = std::move(x);
+        }
+        return SortStrategy::Insertion;
+    }
+
+    constexpr std::size_t kMaxRuns = 64;
+    std::vector<std::size_t> runStarts{0};               /** Run start positions, then n. */
+    bool reversedOnly = false;
+    for (std::size_t i = 0; i < n && runStarts.size() <= kMaxRuns;) {
+        std::size_t j = i + 1;
+        if (j < n && v[j] < v[i]) {
+            while (j < n && v[j] < v[j - 1]) ++j;     /** Strictly descending run. */
+            std::reverse(v + i, v + j);
+            reversedOnly = (i == 0 && j == n);
+        } else {
+            while (j < n && !(v[j] < v[j - 1])) ++j;  /** Non-descending run. */
+        }
+        runStarts.push_back(j);
+        i = j;
+    }
+    const std::size_t runs = runStarts.size() - 1;
+    if (runStarts.back() == n && runs == 1) return reversedOnly ? SortStrategy::Reversed : SortStrategy::AlreadySorted;
+
+    if (runStarts.back() == n) {
+        while (runStarts.size() > 2) {                   /** Merge neighbouring runs until one is left. */
+            std::vector<std::size_t> next{0};
+            for (std::size_t r = 0; r + 1 < runStarts.size(); r += 2) {
+                if (r + 2 < runStarts.size()) {
+                    std::inplace_merge(v + runStarts[r], v + runStarts[r + 1], v + runStarts[r + 2]);
+                    next.push_back(runStarts[r + 2]);
+                } else {
+                    next.push_back(runStarts[r + 1]);
+                }
+            }
+            runStarts.swap(next);
+        }
+        return SortStrategy::RunMerge;
+    }
+
+    if constexpr (CountingKey<T>::enabled) {
+        using K = CountingKey<T>;
+        std::pair<T, T> b;
+        if (bounds) {
+            b = *bounds;
+        } else {
+            auto mm = std::minmax_element(v, v + n);
+            b = {*mm.first, *mm.second};
+        }
+        const std::uint64_t range = K::toKey(b.second) - K::toKey(b.first);
+        if (range < std::max<std::uint64_t>(n, 256)) {
+            countingSort(v, n, b.first, static_cast<std::size_t>(range) + 1);
+            return SortStrategy::Counting;
+        }
+    }
+    if constexpr (RadixKey<T>::enabled) {
+        if (n >= 256) {
+            radixSort(v, n);
+            return SortStrategy::Radix;
+        }
+    }
+    std::sort(v, v + n);
+    return SortStrategy::Comparison;
+}
+
+/** @brief Vector overload of adaptiveSort (sorts the whole vector). */
+template <typename T>
+SortStrategy adaptiveSort(std::vector<T>& v, const std::optional<std::pair<T, T>>& bounds = std::nullopt) {
+    return adaptiveSort(v.data(), v.data() + v.size(), bounds);
+}
+
+/**
+ * @brief Sort a vector whose first `sortedPrefix` elements are already ascending.
+ * @param v            Values to sort in place.
+ * @param sortedPrefix Length of the known-sorted prefix.
+ * @param bounds       Known {min, max} of `v`, forwarded to adaptiveSort.
+ * @return PrefixMerge if only the suffix was sorted and merged, else the adaptiveSort strategy.
+ *
+ * When more than 32 elements are present and at least half of them form a sorted prefix,
+ * only the suffix is sorted and one linear merge joins the two parts: O(m log m + n) for
+ * a suffix of m elements.
+ */
+template <typename T>
+SortStrategy adaptiveSortWithPrefix(std::vector<T>& v, std::size_t sortedPrefix,
+                                    const std::optional<std::pair<T, T>>& bounds = std::nullopt) {
+    const std::size_t n = v.size();
+    if (sortedPrefix >= n) return SortStrategy::AlreadySorted;
+    if (n <= 32 || sortedPrefix < n / 2) return adaptiveSort(v, bounds);
+    adaptiveSort(v.data() + sortedPrefix, v.data() + n, bounds);         /** Bounds of the whole also bound the suffix. */
+    std::inplace_merge(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(sortedPrefix), v.end());
+    return SortStrategy::PrefixMerge;
+}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include "../Instrumentation/Trace.hpp"
+
+namespace ex4 {
+
+/**
+ * @struct DistinctRuns
+ * @brief Run-length summary of an ascending view: one entry per distinct value.
+ *
+ * Overview:
+ *  - Equal runs are equivalence classes of `<` (neither a < b nor b < a); the first
+ *    element of each run in the sorted view is its representative.
+ *  - `values` is itself ascending, so the unique iterators are ordinary Ascending /
+ *    DescendingOrder iterators over it and touch each distinct value exactly once.
+ *  - Immutable once built; MyContainer caches one per mutation, like SortedIndex.
+ */
+template <typename T>
+struct DistinctRuns {
+    std::vector<T> values;              /** Distinct values, ascending. */
+    std::vector<std::size_t> ends;      /** ends[i] = one past the last position of values[i]'s run. */
+
+    /**
+     * @brief Summarize an ascending view.
+     * @param sorted Values in ascending order.
+     * @return Shared, immutable summary.
+     * Complexity: O(n) time, O(distinct) extra space.
+     */
+    static std::shared_ptr<const DistinctRuns> build(const std::vector<T>& sorted) {
+        EX4_TRACE_SPAN("DistinctRuns::build");
+        auto runs = std::make_shared<DistinctRuns>();
+        for (std::size_t i = 0; i < sorted.size(); ++i) {
+            if (i == 0 || sorted[i - 1] < sorted[i]) {
+                if (i != 0) runs->ends.push_back(i);
+                runs->values.push_back(sorted[i]);
+            }
+        }
+        if (!sorted.empty()) runs->ends.push_back(sorted.size());
+        return runs;
+    }
+
+    /** @return Number of distinct values. */
+    std::size_t size() const { return values.size(); }
+
+    /** @return Multiplicity of values[i]. */
+    std::size_t count(std::size_t i) const { return ends[i] - (i == 0 ? 0 : ends[i - 1]); }
+};
+
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "../Instrumentation/Trace.hpp"
+
+namespace ex4 {
+
+/**
+ * @class EytzingerIndex
+ * @brief Search-friendly copy of a sorted vector in Eytzinger (BFS) order.
+ *
+ * Overview:
+ *  - Slot k (1-based) is a node of an implicit binary search tree whose children are
+ *    2k and 2k+1, so the first levels of every search share a few cache lines and the
+ *    next levels are contiguous: the kBlock descendants of k that lie log2(kBlock) levels
+ *    below it share one 64-byte line (16 slots, four levels, for 4-byte T).
+ *  - `lowerBound` is branchless (the comparison result becomes part of the next index)
+ *    and prefetches that line log2(kBlock) levels ahead, so the misses of consecutive
+ *    levels overlap instead of stalling one after another.
+ *  - Every slot also stores its rank in the sorted order, so a search result maps straight
+ *    back to a position in the sorted view (for iterators and range counts).
+ *
+ * Immutable once built; MyContainer shares one instance per mutation, like SortedIndex.
+ */
+template <typename T>
+class EytzingerIndex {
+    std::vector<T> tree;                 /** tree[1..n] in BFS order (tree[0] unused). */
+    std::vector<std::uint32_t> rank;     /** rank[k] = position of tree[k] in the sorted input. */
+
+    /** Slots per 64-byte cache line: tree[k * kBlock] lies log2(kBlock) levels below k. */
+    static constexpr std::size_t kBlock = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+    /** @brief In-order fill: the k-th subtree receives the next run of sorted values. */
+    void fill(const std::vector<T>& sorted, std::size_t& i, std::size_t k) {
+        if (k >= tree.size()) return;
+        fill(sorted, i, 2 * k);
+        tree[k] = sorted[i];
+        rank[k] = static_cast<std::uint32_t>(i++);
+        fill(sorted, i, 2 * k + 1);
+    }
+
+    /**
+     * @brief Branchless descent that turns right while `goRight(tree[k])` holds.
+     * @return Slot of the last node where the search turned left (0 if it never did).
+     */
+    template <typename GoRight>
+    std::size_t descend(GoRight goRight) const {
+        const std::size_t n = size();
+        const T* base = tree.data();
+        std::size_t k = 1;
+        while (k <= n) {
+#if defined(__GNUC__)
+            /** Address arithmetic on integers: the prefetch may point past the array. */
+            __builtin_prefetch(reinterpret_cast<const void*>(
+                reinterpret_cast<std::uintptr_t>(base) + k * kBlock * sizeof(T)));
+#endif
+            k = 2 * k + static_cast<std::size_t>(goRight(base[k]));
+        }
+        return dropRightTurns(k);
+    }
+
+    /** @return `k` without its trailing 1-bits (right turns) and the 0-bit (left turn) above them. */
+    static std::size_t dropRightTurns(std::size_t k) {
+#if defined(__GNUC__)
+        return k >> __builtin_ffsll(static_cast<long long>(~k));
+#else
+        while (k & 1) k >>= 1;
+        return k >> 1;
+#endif
+    }
+
+public:
+    /** Largest input for which ranks fit the 32-bit rank table. */
+    static constexpr std::size_t kMaxSize = UINT32_MAX;
+
+    /**
+     * @brief Build the layout from ascending values.
+     * @param sorted Values in ascending order (at most kMaxSize of them).
+     * Complexity: O(n) time, n extra values plus n 32-bit ranks.
+     */
+    explicit EytzingerIndex(const std::vector<T>& sorted) : tree(sorted.size() + 1), rank(sorted.size() + 1) {
+        EX4_TRACE_SPAN("EytzingerIndex::build");
+        std::size_t i = 0;
+        fill(sorted, i, 1);
+    }
+
+    /** @return Number of indexed values. */
+    std::size_t size() const { return tree.size() - 1; }
+
+    /**
+     * @brief Rank of the first value not less than `value`.
+     * @return Position in the sorted input, or size() if every value is smaller.
+     * Complexity: O(log n) with one (overlapped) cache miss per log2(kBlock) levels.
+     */
+    std::size_t lowerBound(const T& value) const {
+        const std::size_t k = descend([&](const T& x) { return x < value; });
+        return k == 0 ? size() : rank[k];
+    }
+
+    /**
+     * @brief Rank of the first value greater than `value`.
+     * @return Position in the sorted input, or size() if no value is greater.
+     */
+    std::size_t upperBound(const T& value) const {
+        const std::size_t k = descend([&](const T& x) { return !(value < x); });
+        return k == 0 ? size() : rank[k];
+    }
+
+    /** @return true if a value equivalent to `value` is indexed. */
+    bool contains(const T& value) const {
+        const std::size_t k = descend([&](const T& x) { return x < value; });
+        return k != 0 && !(value < tree[k]);
+    }
+};
+
+}
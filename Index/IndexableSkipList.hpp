@@ -0,0 +1,202 @@
+#pragma once
+#include <vector>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+
+namespace ex4 {
+
+/**
+ * @class IndexableSkipList
+ * @brief Ordered multiset with O(log n) insert, erase and rank lookup.
+ *
+ * Overview:
+ *  - A skip list whose forward links also store their width (number of level-0 steps they
+ *    skip), so the k-th smallest element is reachable in O(log n) expected time.
+ *  - Equal elements are kept in insertion order (a new element goes after its equals), so
+ *    `eraseFirst()` removes the oldest of several equivalent values.
+ *  - Level 0 is doubly linked, which makes descending traversal O(1) per step.
+ */
+template <typename T>
+class IndexableSkipList {
+public:
+    struct Node;
+
+    /** Forward links of one node (or of the head sentinel). */
+    struct Tower {
+        std::vector<Node*> next;         /** Successor per level. */
+        std::vector<std::size_t> width;  /** Level-0 steps covered by each forward link. */
+        Node* prev = nullptr;            /** Level-0 predecessor (nullptr for the first node). */
+    };
+
+    struct Node : Tower {
+        T value;
+        explicit Node(const T& v) : value(v) {}
+    };
+
+private:
+    static constexpr std::size_t kMaxLevel = 32;
+
+    Tower head;                /** Sentinel tower with kMaxLevel levels. */
+    Node* tail = nullptr;      /** Largest element. */
+    std::size_t levels = 1;    /** Levels currently in use. */
+    std::size_t count = 0;     /** Number of elements. */
+    std::uint64_t rng = 0x9E3779B97F4A7C15ULL;  /** xorshift state for level selection. */
+
+    /** @return A random level in [1, kMaxLevel] with P(level > k) = 4^-k. */
+    std::size_t randomLevel() {
+        std::size_t lvl = 1;
+        while (lvl < kMaxLevel) {
+            rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+            if ((rng & 3U) != 0) break;
+            ++lvl;
+        }
+        return lvl;
+    }
+
+    void destroy() {
+        Node* x = head.next[0];
+        while (x) {
+            Node* n = x->next[0];
+            delete x;
+            x = n;
+        }
+    }
+
+    void reset() {
+        head.next.assign(kMaxLevel, nullptr);
+        head.width.assign(kMaxLevel, 0);
+        tail = nullptr;
+        levels = 1;
+        count = 0;
+    }
+
+public:
+    IndexableSkipList() { reset(); }
+    ~IndexableSkipList() { destroy(); }
+
+    IndexableSkipList(const IndexableSkipList& other) : IndexableSkipList() {
+        for (const Node* x = other.first(); x; x = x->next[0]) insert(x->value);
+    }
+
+    IndexableSkipList& operator=(const IndexableSkipList& other) {
+        if (this != &other) {
+            clear();
+            for (const Node* x = other.first(); x; x = x->next[0]) insert(x->value);
+        }
+        return *this;
+    }
+
+    /** @brief Remove every element. */
+    void clear() {
+        destroy();
+        reset();
+    }
+
+    /** @return Number of elements. */
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    /** @return Smallest node (nullptr if empty); follow `next[0]` for ascending order. */
+    const Node* first() const { return head.next[0]; }
+
+    /** @return Largest node (nullptr if empty); follow `prev` for descending order. */
+    const Node* last() const { return tail; }
+
+    /**
+     * @brief Insert a value after any equal values.
+     * Complexity: O(log n) expected.
+     */
+    void insert(const T& value) {
+        Tower* update[kMaxLevel];
+        std::size_t rank[kMaxLevel];
+        Tower* x = &head;
+        for (std::size_t l = levels; l-- > 0;) {
+            rank[l] = (l + 1 == levels) ? 0 : rank[l + 1];
+            while (x->next[l] && !(value < x->next[l]->value)) {
+                rank[l] += x->width[l];
+                x = x->next[l];
+            }
+            update[l] = x;
+        }
+
+        const std::size_t lvl = randomLevel();
+        if (lvl > levels) {
+            for (std::size_t l = levels; l < lvl; ++l) {
+                rank[l] = 0;
+                update[l] = &head;
+                head.width[l] = count;
+            }
+            levels = lvl;
+        }
+
+        Node* node = new Node(value);
+        node->next.assign(lvl, nullptr);
+        node->width.assign(lvl, 0);
+        for (std::size_t l = 0; l < lvl; ++l) {
+            node->next[l] = update[l]->next[l];
+            update[l]->next[l] = node;
+            node->width[l] = update[l]->width[l] - (rank[0] - rank[l]);
+            update[l]->width[l] = rank[0] - rank[l] + 1;
+        }
+        for (std::size_t l = lvl; l < levels; ++l) ++update[l]->width[l];
+
+        node->prev = (update[0] == &head) ? nullptr : static_cast<Node*>(update[0]);
+        if (node->next[0]) node->next[0]->prev = node;
+        else tail = node;
+        ++count;
+    }
+
+    /**
+     * @brief Remove the oldest element equivalent to `value`.
+     * @return false if no equivalent element exists.
+     * Complexity: O(log n) expected.
+     */
+    bool eraseFirst(const T& value) {
+        Tower* update[kMaxLevel];
+        Tower* x = &head;
+        for (std::size_t l = levels; l-- > 0;) {
+            while (x->next[l] && x->next[l]->value < value) x = x->next[l];
+            update[l] = x;
+        }
+        Node* target = x->next[0];
+        if (!target || value < target->value) return false;
+
+        for (std::size_t l = 0; l < levels; ++l) {
+            if (update[l]->next[l] == target) {
+                update[l]->width[l] += target->width[l] - 1;
+                update[l]->next[l] = target->next[l];
+            } else {
+                --update[l]->width[l];
+            }
+        }
+        if (target->next[0]) target->next[0]->prev = target->prev;
+        else tail = target->prev;
+        while (levels > 1 && !head.next[levels - 1]) --levels;
+        --count;
+        delete target;
+        return true;
+    }
+
+    /**
+     * @brief k-th smallest element (0-based).
+     * @throws std::out_of_range if k >= size().
+     * Complexity: O(log n) expected.
+     */
+    const T& at(std::size_t k) const {
+        if (k >= count) throw std::out_of_range("Rank is out of range");
+        const std::size_t target = k + 1;
+        std::size_t traversed = 0;
+        const Tower* x = &head;
+        for (std::size_t l = levels; l-- > 0;) {
+            while (x->next[l] && traversed + x->width[l] <= target) {
+                traversed += x->width[l];
+                x = x->next[l];
+            }
+            if (traversed == target) break;
+        }
+        return static_cast<const Node*>(x)->value;
+    }
+};
+
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+#include "AdaptiveSort.hpp"
+#include "../Instrumentation/Trace.hpp"
+
+namespace ex4 {
+
+/**
+ * @struct SortedIndex
+ * @brief Immutable ascending copy of a container's elements, shared by the sorted iterators.
+ *
+ * Overview:
+ *  - Built lazily by MyContainer the first time a sorted order is requested and cached
+ *    until the next mutation ("warm" index).
+ *  - AscendingOrder, DescendingOrder and SideCrossOrder all read the same `keys` vector
+ *    through index arithmetic, so a warm traversal neither copies nor sorts.
+ *  - An index built with positions also records where each key sits in insertion order
+ *    (the argsort permutation); equal keys then keep their insertion order.
+ */
+template <typename T>
+struct SortedIndex {
+    std::vector<T> keys;   /** Elements in ascending order. */
+    SortStrategy strategy = SortStrategy::None;  /** How `keys` was sorted (see adaptiveSort). */
+    std::vector<std::uint32_t> positions;  /** positions[i] = insertion index of keys[i] (empty unless built with positions). */
+
+    /**
+     * @brief Build an index from insertion-order data.
+     * @param data         Source elements.
+     * @param sortedPrefix Length of the prefix of `data` known to be ascending (0 if unknown).
+     * @param bounds       {min, max} of `data` if known (lets small-range integers use counting sort).
+     * @return Shared, immutable index.
+     *
+     * Complexity: O(n) for presorted input, O(n log runs) for few runs, O(n + range) for
+     *             small-range integers, O(n log n) otherwise.
+     */
+    static std::shared_ptr<const SortedIndex> build(const std::vector<T>& data, std::size_t sortedPrefix = 0,
+                                                    const std::optional<std::pair<T, T>>& bounds = std::nullopt) {
+        EX4_TRACE_SPAN("SortedIndex::build");
+        auto idx = std::make_shared<SortedIndex>();
+        idx->keys = data;                                   /** Single copy of the elements. */
+        {
+            EX4_TRACE_SPAN("SortedIndex::sort");
+            idx->strategy = adaptiveSortWithPrefix(idx->keys, sortedPrefix, bounds); /** Sort in place, adapting to runs. */
+        }
+        return idx;
+    }
+
+    /**
+     * @brief Build an index that also records the sorted permutation (`positions`).
+     * @param data         Source elements (at most UINT32_MAX of them).
+     * @param sortedPrefix Length of the prefix of `data` known to be ascending (0 if unknown).
+     * @return Shared, immutable index; ties are ordered by insertion index.
+     * @throws std::length_error if `data` has more elements than 32-bit positions can address.
+     *
+     * Arithmetic keys of up to 4 bytes are packed with their position into one uint64_t
+     * (order-preserving key bits high, position low), so the pairs stay radix-sortable and
+     * ties need no extra pass. Other types sort (key, position) pairs, so comparisons read
+     * contiguous memory. Either way only the suffix after `sortedPrefix` is sorted and one
+     * linear merge joins it to the prefix.
+     * Complexity: O(m log m + n) for an unsorted suffix of m elements (O(n) passes for radix).
+     */
+    static std::shared_ptr<const SortedIndex> buildWithPositions(const std::vector<T>& data, std::size_t sortedPrefix = 0) {
+        EX4_TRACE_SPAN("SortedIndex::buildWithPositions");
+        const std::size_t n = data.size();
+        if (n > UINT32_MAX) throw std::length_error("Container too large for 32-bit positions");
+        sortedPrefix = std::min(sortedPrefix, n);
+
+        if constexpr (RadixKey<T>::enabled && sizeof(T) <= 4) {
+            std::vector<std::uint64_t> packed(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                const T& v = data[i];
+                const T key = v == T(0) ? T(0) : v;                 /** -0.0 and 0.0 tie, ordered by position. */
+                packed[i] = (static_cast<std::uint64_t>(RadixKey<T>::toKey(key)) << 32) | i;
+            }
+            auto idx = std::make_shared<SortedIndex>();
+            {
+                EX4_TRACE_SPAN("SortedIndex::sort");
+                idx->strategy = adaptiveSortWithPrefix(packed, sortedPrefix);  /** The sorted prefix stays sorted when packed. */
+            }
+            idx->keys.resize(n);
+            idx->positions.resize(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto pos = static_cast<std::uint32_t>(packed[i]);
+                idx->positions[i] = pos;
+                idx->keys[i] = data[pos];
+            }
+            return idx;
+        } else {
+            using Entry = std::pair<T, std::uint32_t>;
+            std::vector<Entry> entries;
+            entries.reserve(n);
+            for (std::size_t i = 0; i < n; ++i) entries.emplace_back(data[i], static_cast<std::uint32_t>(i));
+            auto byKeyThenPosition = [](const Entry& a, const Entry& b) {
+                if (a.first < b.first) return true;
+                if (b.first < a.first) return false;
+                return a.second < b.second;
+            };
+            const auto mid = entries.begin() + static_cast<std::ptrdiff_t>(sortedPrefix);
+            {
+                EX4_TRACE_SPAN("SortedIndex::sort");
+                std::sort(mid, entries.end(), byKeyThenPosition);
+                std::inplace_merge(entries.begin(), mid, entries.end(), byKeyThenPosition);
+            }
+
+            auto idx = std::make_shared<SortedIndex>();
+            idx->strategy = sortedPrefix == n ? SortStrategy::AlreadySorted
+                          : sortedPrefix > 0  ? SortStrategy::PrefixMerge
+                                              : SortStrategy::Comparison;
+            idx->keys.reserve(n);
+            idx->positions.reserve(n);
+            for (Entry& e : entries) {
+                idx->keys.push_back(std::move(e.first));
+                idx->positions.push_back(e.second);
+            }
+            return idx;
+        }
+    }
+
+    /**
+     * @brief Index of `base` without the keys `drop` selects, plus `added`: one filter pass and
+     *        one merge instead of a rebuild (used by MyContainer batch commits).
+     * @param base  Current index (its keys are already ascending).
+     * @param drop  Predicate, true for keys to leave out.
+     * @param first,last New elements, in any order.
+     * @return Shared, immutable index without positions.
+     * Complexity: O(n) filter + O(m log m + n) sort-and-merge for m added elements.
+     */
+    template <typename Drop, typename It>
+    static std::shared_ptr<const SortedIndex> patch(const SortedIndex& base, Drop drop, It first, It last) {
+        EX4_TRACE_SPAN("SortedIndex::patch");
+        auto idx = std::make_shared<SortedIndex>();
+        idx->keys.reserve(base.keys.size() + static_cast<std::size_t>(std::distance(first, last)));
+        for (const T& k : base.keys) {
+            if (!drop(k)) idx->keys.push_back(k);
+        }
+        const std::size_t kept = idx->keys.size();
+        idx->keys.insert(idx->keys.end(), first, last);
+        {
+            EX4_TRACE_SPAN("SortedIndex::sort");
+            idx->strategy = adaptiveSortWithPrefix(idx->keys, kept);   /** Sorts only the new elements, then merges. */
+        }
+        return idx;
+    }
+};
+
+}
@@ -0,0 +1,210 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <string>
+#include <sstream>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Opt-in instrumentation for MyContainer.
+ *
+ * Compile with -DEX4_ENABLE_STATS to record counters and latency histograms.
+ * Without it, every `EX4_STATS(...)` statement expands to nothing and MyContainer
+ * carries no stats member, so the instrumentation has zero cost.
+ */
+#ifdef EX4_ENABLE_STATS
+#define EX4_STATS(stmt) stmt
+#else
+#define EX4_STATS(stmt)
+#endif
+
+namespace ex4 {
+
+/** Traversal orders tracked by the instrumentation (one slot each). */
+enum class OrderKind : std::size_t {
+    Insertion, Reverse, Ascending, Descending, SideCross, MiddleOut, Count
+};
+
+/** @return Stable lower-case name of an order (used as JSON key). */
+inline const char* orderName(OrderKind k) {
+    static const char* const names[] = {
+        "insertion", "reverse", "ascending", "descending", "side_cross", "middle_out"
+    };
+    return names[static_cast<std::size_t>(k)];
+}
+
+/**
+ * @class LatencyHistogram
+ * @brief HDR-style histogram of nanosecond latencies with fixed memory.
+ *
+ * Overview:
+ *  - Values are bucketed by power-of-two magnitude, and every magnitude is split into
+ *    8 linear sub-buckets, so any recorded value is off by at most 12.5%.
+ *  - Recording is O(1) and never allocates; percentiles are O(buckets).
+ */
+class LatencyHistogram {
+    static constexpr unsigned kSubBits = 3;                     /** log2(sub-buckets per magnitude). */
+    static constexpr std::uint64_t kSub = 1U << kSubBits;      /** Sub-buckets per magnitude. */
+    static constexpr std::size_t kBuckets = (64 - kSubBits + 1) * kSub;
+
+    std::array<std::uint64_t, kBuckets> counts{};  /** Per-bucket sample counts. */
+    std::uint64_t total = 0;                        /** Number of samples. */
+    std::uint64_t sum = 0;                          /** Sum of samples (for the mean). */
+    std::uint64_t lo = UINT64_MAX;                  /** Smallest sample. */
+    std::uint64_t hi = 0;                           /** Largest sample. */
+
+    /** @return Index of the highest set bit of a non-zero `v`. */
+    static unsigned highestBit(std::uint64_t v) {
+#if defined(__GNUC__)
+        return 63U - static_cast<unsigned>(__builtin_clzll(v));
+#else
+        unsigned mag = 0;
+        while (v >>= 1) ++mag;
+        return mag;
+#endif
+    }
+
+    static std::size_t bucketOf(std::uint64_t v) {
+        if (v < kSub) return static_cast<std::size_t>(v);      /** Exact buckets for tiny values. */
+        unsigned mag = highestBit(v);
+        std::uint64_t sub = (v >> (mag - kSubBits)) & (kSub - 1);
+        return static_cast<std::size_t>((mag - kSubBits + 1) * kSub + sub);
+    }
+
+    static std::uint64_t lowerBoundOf(std::size_t b) {
+        if (b < kSub) return b;
+        unsigned mag = static_cast<unsigned>(b / kSub) + kSubBits - 1;
+        return (kSub + b % kSub) << (mag - kSubBits);
+    }
+
+public:
+    /** @brief Add one sample (nanoseconds). */
+    void record(std::uint64_t ns) {
+        ++counts[bucketOf(ns)];
+        ++total;
+        sum += ns;
+        if (ns < lo) lo = ns;
+        if (ns > hi) hi = ns;
+    }
+
+    std::uint64_t count() const { return total; }
+    std::uint64_t min() const { return total ? lo : 0; }
+    std::uint64_t max() const { return hi; }
+    double mean() const { return total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0; }
+
+    /**
+     * @brief Approximate percentile.
+     * @param p Percentile in [0, 100].
+     * @return Lower bound of the bucket holding the p-th percentile sample (0 if empty).
+     */
+    std::uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        std::uint64_t rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(total - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < kBuckets; ++b) {
+            seen += counts[b];
+            if (seen >= rank) return lowerBoundOf(b);
+        }
+        return hi;
+    }
+
+    /** @brief Write the summary as a JSON object. */
+    void toJson(std::ostream& os) const {
+        os << "{\"count\":" << total << ",\"min\":" << min() << ",\"max\":" << max()
+           << ",\"mean\":" << mean() << ",\"p50\":" << percentile(50) << ",\"p90\":" << percentile(90)
+           << ",\"p99\":" << percentile(99) << ",\"p999\":" << percentile(99.9) << '}';
+    }
+};
+
+/** Counters for one traversal order. */
+struct OrderStats {
+    std::uint64_t snapshots = 0;      /** Number of `make()` calls (begin/end pairs built). */
+    std::uint64_t sorts = 0;          /** Number of sorts performed while building views. */
+    std::uint64_t bytesCopied = 0;    /** Element bytes copied into iterator views. */
+    std::uint64_t allocations = 0;    /** Heap buffers allocated for iterator views. */
+    LatencyHistogram makeLatency;     /** Wall time of `make()`. */
+};
+
+/**
+ * @class ContainerStats
+ * @brief Per-container counters and latency histograms, filled when EX4_ENABLE_STATS is set.
+ */
+class ContainerStats {
+    std::array<OrderStats, static_cast<std::size_t>(OrderKind::Count)> orders{};
+
+public:
+    std::uint64_t adds = 0;           /** Successful `addElement` calls, plus adds of committed batches. */
+    std::uint64_t removes = 0;        /** `removeElement` / `tryRemoveElement` calls (including misses),
+                                          plus removes of committed batches. */
+    std::uint64_t commits = 0;        /** Successful `Batch::commit` calls. */
+    LatencyHistogram addLatency;      /** Wall time of `addElement`. */
+    LatencyHistogram removeLatency;   /** Wall time of `removeElement`. */
+    LatencyHistogram commitLatency;   /** Wall time of `Batch::commit` (including ones that threw). */
+
+    OrderStats& order(OrderKind k) { return orders[static_cast<std::size_t>(k)]; }
+    const OrderStats& order(OrderKind k) const { return orders[static_cast<std::size_t>(k)]; }
+
+    /**
+     * @brief Account for one view copy made while building iterators.
+     * @param k     Order being built.
+     * @param bytes  Bytes per copy (elements * sizeof(T)).
+     * @param copies Number of identical copies made (e.g. one per iterator of a begin/end pair).
+     */
+    void recordCopy(OrderKind k, std::size_t bytes, std::size_t copies = 1) {
+        OrderStats& s = order(k);
+        s.bytesCopied += bytes * copies;
+        if (bytes) s.allocations += copies;   /** std::vector does not allocate for an empty copy. */
+    }
+
+    /** @brief Write all counters and histograms as one JSON object. */
+    void toJson(std::ostream& os) const {
+        os << "{\"adds\":" << adds << ",\"removes\":" << removes << ",\"commits\":" << commits
+           << ",\"add_latency_ns\":";
+        addLatency.toJson(os);
+        os << ",\"remove_latency_ns\":";
+        removeLatency.toJson(os);
+        os << ",\"commit_latency_ns\":";
+        commitLatency.toJson(os);
+        os << ",\"orders\":{";
+        for (std::size_t i = 0; i < orders.size(); ++i) {
+            const OrderStats& s = orders[i];
+            if (i) os << ',';
+            os << '"' << orderName(static_cast<OrderKind>(i)) << "\":{\"snapshots\":" << s.snapshots
+               << ",\"sorts\":" << s.sorts << ",\"bytes_copied\":" << s.bytesCopied
+               << ",\"allocations\":" << s.allocations << ",\"make_latency_ns\":";
+            s.makeLatency.toJson(os);
+            os << '}';
+        }
+        os << "}}";
+    }
+
+    /** @return The JSON dump as a string. */
+    std::string json() const {
+        std::ostringstream os;
+        toJson(os);
+        return os.str();
+    }
+};
+
+/**
+ * @class ScopedLatency
+ * @brief RAII timer that records its lifetime into a LatencyHistogram.
+ */
+class ScopedLatency {
+    LatencyHistogram& hist;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedLatency(LatencyHistogram& h) : hist(h), start(std::chrono::steady_clock::now()) {}
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+    ~ScopedLatency() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        hist.record(static_cast<std::uint64_t>(ns));
+    }
+};
+
+}
@@ -0,0 +1,226 @@
+#pragma once
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <fstream>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+/**
+ * Opt-in tracing spans for the hot paths of MyContainer.
+ *
+ * Compile with -DEX4_ENABLE_TRACE to record a span around every iterator `make()`,
+ * the sorted-index sort step and `removeElement`. Spans go to the process-wide
+ * TraceRecorder, which writes the Chrome trace event format (load the file in
+ * chrome://tracing or https://ui.perfetto.dev for a flame chart). If the environment
+ * variable EX4_TRACE_FILE is set, the trace is written there at program exit.
+ *
+ * Also define EX4_TRACE_USDT (needs <sys/sdt.h>, e.g. systemtap-sdt-dev) to emit the
+ * USDT probes `ex4:span_enter(name)` / `ex4:span_exit(name, ns)` for perf/bpftrace.
+ *
+ * Without EX4_ENABLE_TRACE, `EX4_TRACE_SPAN(name)` expands to nothing.
+ */
+#if defined(EX4_TRACE_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define EX4_USDT_ENTER(name) DTRACE_PROBE1(ex4, span_enter, name)
+#define EX4_USDT_EXIT(name, ns) DTRACE_PROBE2(ex4, span_exit, name, ns)
+#endif
+#endif
+#ifndef EX4_USDT_ENTER
+#define EX4_USDT_ENTER(name)
+#define EX4_USDT_EXIT(name, ns)
+#endif
+
+#define EX4_TRACE_CONCAT_(a, b) a##b
+#define EX4_TRACE_CONCAT(a, b) EX4_TRACE_CONCAT_(a, b)
+#ifdef EX4_ENABLE_TRACE
+#define EX4_TRACE_SPAN(name) ::ex4::TraceSpan EX4_TRACE_CONCAT(ex4_span_, __LINE__)(name)
+#else
+#define EX4_TRACE_SPAN(name)
+#endif
+
+namespace ex4 {
+
+/**
+ * @class TraceRecorder
+ * @brief Process-wide collector of completed spans, serialized as Chrome trace JSON.
+ *
+ * Notes:
+ *  - Span names must be string literals (only the pointer is stored).
+ *  - Recording takes a mutex and writes into a ring buffer; it is meant for profiling builds.
+ *  - Memory is bounded: at most `capacity()` events are kept (kDefaultCapacity, 2^20 events of
+ *    32 bytes = 32 MiB, unless changed with setCapacity). Once full, each new span overwrites
+ *    the oldest one and `dropped()` counts the overwritten spans, so a long-running process
+ *    keeps its most recent activity. The dump reports the count as `otherData.dropped_events`.
+ */
+class TraceRecorder {
+public:
+    /** One completed span ("X" event in the Chrome format). */
+    struct Event {
+        const char* name;      /** Span name (string literal). */
+        std::uint64_t startNs; /** Start, relative to the recorder epoch. */
+        std::uint64_t durNs;   /** Duration. */
+        std::uint32_t tid;     /** Small per-thread id. */
+    };
+
+    static constexpr std::size_t kDefaultCapacity = std::size_t{1} << 20;
+
+private:
+    std::mutex lock;
+    std::vector<Event> events;                      /** Ring of at most `limit` events. */
+    std::size_t limit = kDefaultCapacity;
+    std::size_t head = 0;                           /** Oldest event once the ring is full. */
+    std::uint64_t overwritten = 0;                  /** Spans dropped to stay within `limit`. */
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    TraceRecorder() = default;
+
+    /** @return The retained events, oldest first (caller holds `lock`). */
+    std::vector<Event> ordered() const {
+        std::vector<Event> out(events.begin() + static_cast<std::ptrdiff_t>(head), events.end());
+        out.insert(out.end(), events.begin(), events.begin() + static_cast<std::ptrdiff_t>(head));
+        return out;
+    }
+
+    ~TraceRecorder() {
+        if (const char* path = std::getenv("EX4_TRACE_FILE")) writeFile(path);
+    }
+
+public:
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /** @return The process-wide recorder. */
+    static TraceRecorder& instance() {
+        static TraceRecorder recorder;
+        return recorder;
+    }
+
+    /** @return Nanoseconds since the recorder was created. */
+    std::uint64_t now() const {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    /** @return A small, stable id for the calling thread. */
+    static std::uint32_t threadId() {
+        static std::atomic<std::uint32_t> next{1};
+        thread_local std::uint32_t id = next.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    /** @brief Append a completed span, overwriting the oldest one if the buffer is full. */
+    void record(const char* name, std::uint64_t startNs, std::uint64_t durNs) {
+        std::lock_guard<std::mutex> guard(lock);
+        const Event e{name, startNs, durNs, threadId()};
+        if (events.size() < limit) {
+            events.push_back(e);
+            return;
+        }
+        ++overwritten;
+        if (limit == 0) return;
+        events[head] = e;
+        head = (head + 1) % limit;
+    }
+
+    /** @return Copy of the retained spans, oldest first. */
+    std::vector<Event> snapshot() {
+        std::lock_guard<std::mutex> guard(lock);
+        return ordered();
+    }
+
+    /** @brief Drop all recorded spans and reset the dropped count. */
+    void clear() {
+        std::lock_guard<std::mutex> guard(lock);
+        events.clear();
+        head = 0;
+        overwritten = 0;
+    }
+
+    /**
+     * @brief Change how many spans are kept; the most recent ones survive a shrink.
+     * @param maxEvents New bound (0 keeps nothing and only counts).
+     */
+    void setCapacity(std::size_t maxEvents) {
+        std::lock_guard<std::mutex> guard(lock);
+        std::vector<Event> kept = ordered();
+        if (kept.size() > maxEvents) {
+            overwritten += kept.size() - maxEvents;
+            kept.erase(kept.begin(), kept.end() - static_cast<std::ptrdiff_t>(maxEvents));
+        }
+        events.swap(kept);
+        head = 0;
+        limit = maxEvents;
+    }
+
+    /** @return Maximum number of retained spans. */
+    std::size_t capacity() {
+        std::lock_guard<std::mutex> guard(lock);
+        return limit;
+    }
+
+    /** @return Number of spans overwritten (or discarded) to stay within capacity(). */
+    std::uint64_t dropped() {
+        std::lock_guard<std::mutex> guard(lock);
+        return overwritten;
+    }
+
+    /**
+     * @brief Write all spans in the Chrome trace event format.
+     * @param os Output stream (timestamps are in microseconds, as the format expects).
+     */
+    void writeChromeTrace(std::ostream& os) {
+        std::lock_guard<std::mutex> guard(lock);
+        os << "{\"traceEvents\":[";
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const Event& e = events[(head + i) % events.size()];
+            if (i) os << ',';
+            os << "{\"name\":\"" << e.name << "\",\"cat\":\"ex4\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.tid
+               << ",\"ts\":" << static_cast<double>(e.startNs) / 1000.0
+               << ",\"dur\":" << static_cast<double>(e.durNs) / 1000.0 << '}';
+        }
+        os << "],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":" << overwritten << "}}";
+    }
+
+    /**
+     * @brief Write the Chrome trace to a file.
+     * @param path Destination path.
+     * @return false if the file could not be opened.
+     */
+    bool writeFile(const std::string& path) {
+        std::ofstream out(path);
+        if (!out) return false;
+        writeChromeTrace(out);
+        return static_cast<bool>(out);
+    }
+};
+
+/**
+ * @class TraceSpan
+ * @brief RAII span: records [construction, destruction) into the TraceRecorder.
+ */
+class TraceSpan {
+    const char* name;
+    std::uint64_t start;
+
+public:
+    explicit TraceSpan(const char* spanName)
+        : name(spanName), start(TraceRecorder::instance().now()) {
+        EX4_USDT_ENTER(name);
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    ~TraceSpan() {
+        TraceRecorder& r = TraceRecorder::instance();
+        const std::uint64_t dur = r.now() - start;
+        EX4_USDT_EXIT(name, dur);
+        r.record(name, start, dur);
+    }
+};
+
+}
@@ -1,7 +1,10 @@
 #pragma once
 #include <vector>    
+#include <memory>    
 #include <algorithm>   
 #include <cstddef>    
+#include "../Instrumentation/Stats.hpp"
+#include "../Instrumentation/Trace.hpp"
 
 namespace ex4 {      
 
@@ -12,24 +15,23 @@ template <typename T> class MyContainer;
  * @brief Lightweight forward iterator over a *snapshot* of the container arranged in ascending order.
  *
 * Overview:
- *  - This iterator maintains a local copy (`view`) of the container's elements sorted in ascending order.
- *  - It uses an index (`idx`) to track the current position during traversal.
+ *  - This iterator shares the container's cached sorted index (`view`); it is only sorted when cold.
  *  - It uses an index (`idx`) to track the current position during traversal.
  */
 template <typename T>
 class AscendingOrder {
 private:
-    std::vector<T> view;  /** Local, sorted copy of the container’s elements. */
+    std::shared_ptr<const std::vector<T>> view;  /** Shared, sorted snapshot of the container’s elements. */
     std::size_t idx;      /** Current position within `view` (0..view.size()). */
 
 public:
     /**
      * @brief Constructs an iterator over a given view starting at position `i`.
-     * @param v   The traversal view (already sorted or to-be-sorted by the caller).
+     * @param v   The traversal view (already sorted ascending).
      * @param i   Starting index (defaults to 0; `view.size()` typically marks the end).
      */
-    AscendingOrder(std::vector<T> v, std::size_t i = 0)
-        : view(std::move(v)),  /** Move-construct the local view to avoid copying. */
+    AscendingOrder(std::shared_ptr<const std::vector<T>> v, std::size_t i = 0)
+        : view(std::move(v)),  /** Take over the reference without copying elements. */
           idx(i)               /** Initialize the current index. */
     {}
 
@@ -39,11 +41,16 @@ public:
      * @return    {begin, end} pair of AscendingOrder iterators.
      */
     static std::pair<AscendingOrder, AscendingOrder> make(const MyContainer<T>& c) {
-        std::vector<T> v = c.getData();          /** Copy current data from the container. */
-        std::sort(v.begin(), v.end());           /**  Sort ascending in-place. */
+        EX4_TRACE_SPAN("AscendingOrder::make");
+        EX4_STATS(OrderStats& st = c.statsSink().order(OrderKind::Ascending);)
+        EX4_STATS(ScopedLatency timer(st.makeLatency);)
+        EX4_STATS(++st.snapshots;)
+        EX4_STATS(const bool cold = !c.isIndexWarm();)
+        auto v = c.sortedSnapshot();             /** Cached sorted index (built once per mutation). */
+        EX4_STATS(if (cold) { ++st.sorts; c.statsSink().recordCopy(OrderKind::Ascending, v->size() * sizeof(T)); })
         return {
             AscendingOrder(v, 0),                /**  Begin: points to the first element. */
-            AscendingOrder(v, v.size())          /**  End: points one-past-the-last element. */
+            AscendingOrder(v, v->size())         /**  End: points one-past-the-last element. */
         };
     }
 
@@ -52,14 +59,14 @@ public:
      * @return A const reference to the current element.
      * @throws std::out_of_range if `idx` is not a valid position (guards via `vector::at`).
      */
-    const T& operator*() const { return view.at(idx); }
+    const T& operator*() const { return view->at(idx); }
 
     /**
      * @brief Arrow operator (read-only).
      * @return Pointer to the current element.
      * @throws std::out_of_range if `idx` is out of bounds (guards via `vector::at`).
      */
-    const T* operator->() const { return &view.at(idx); }
+    const T* operator->() const { return &view->at(idx); }
 
     /**
      * @brief Prefix increment: advance to the next element, then return *this.
@@ -77,13 +84,39 @@ public:
         return tmp;                  /** Return the prior state. */
     }
 
+    /**
+     * @brief Copy up to `n` elements from the current position into `out`, then advance past them.
+     * @param out Caller buffer with room for at least `n` elements.
+     * @param n   Maximum number of elements to copy.
+     * @return Number of elements written (0 once the end is reached).
+     *
+     * Ascending order is contiguous in the sorted view, so this is one block copy.
+     */
+    std::size_t next_batch(T* out, std::size_t n) {
+        const std::size_t k = copy_to(out, n);
+        idx += k;
+        return k;
+    }
+
+    /**
+     * @brief Same as `next_batch` but leaves the iterator where it is.
+     * @return Number of elements written.
+     */
+    std::size_t copy_to(T* out, std::size_t n) const {
+        const std::size_t size = view->size();
+        const std::size_t from = std::min(idx, size);          /** Past-the-end iterators copy nothing. */
+        const std::size_t k = std::min(n, size - from);
+        std::copy_n(view->data() + from, k, out);             /** Contiguous: memcpy for trivially copyable T. */
+        return k;
+    }
+
     /**
      * @brief Equality comparison.
      * @param other Another AscendingOrder iterator.
      * @return true if both iterators refer to the same view and index.
      */
     bool operator==(const AscendingOrder& other) const {
-        return idx == other.idx && view == other.view;
+        return idx == other.idx && (view == other.view || *view == *other.view);
     }
 
     /**
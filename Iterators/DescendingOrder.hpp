@@ -1,8 +1,11 @@
 #pragma once
 #include <vector>       
+#include <memory>       
 #include <algorithm>   
 #include <functional>  
 #include <cstddef>      
+#include "../Instrumentation/Stats.hpp"
+#include "../Instrumentation/Trace.hpp"
 
 namespace ex4 {       
 
@@ -12,38 +15,46 @@ template <typename T> class MyContainer;
  * @class DescendingOrder
  * @brief A lightweight forward iterator for traversing elements of a container in descending order.
  * Overview:
- *  - This iterator maintains a local copy (`view`) of the container's elements sorted in descending order.
- *  - It uses an index (`idx`) to track the current position during traversal.
+ *  - This iterator shares the container's cached ascending index (`view`) and reads it back to front.
+ *  - It uses an index (`idx`) to track the current position during traversal (0 = largest element).
  *  - The iterator supports standard operations: dereference, prefix/postfix increment, and equality/inequality comparisons.
  * 
  */
 template <typename T>
 class DescendingOrder {
-    std::vector<T> view;   /** Local copy of elements sorted in descending order. */
-    std::size_t idx;       /** Current position within the `view`. */
+    std::shared_ptr<const std::vector<T>> view;   /** Shared snapshot sorted in ascending order. */
+    std::size_t idx;       /** Current traversal position (0..view.size()). */
+
+    /** @return Position in `view` of the current element (out of range once `idx` reaches the end). */
+    std::size_t position() const { return view->size() - 1 - idx; }
 
 public:
     /**
      * @brief Constructor initializing the iterator with a given view and starting index.
-     * @param v   A vector representing the traversal view (already sorted or ready to be sorted).
+     * @param v   The ascending sorted view (traversed from the back).
      * @param i   The starting index (defaults to 0).
      */
-    DescendingOrder(std::vector<T> v, std::size_t i = 0)
+    DescendingOrder(std::shared_ptr<const std::vector<T>> v, std::size_t i = 0)
         : view(std::move(v)),  /** Move `v` into `view` to avoid copying. */
           idx(i)               /** Initialize the iterator position to `i`. */
     {}
 
     /**
      * @brief Factory function that constructs a begin/end pair for descending traversal.
-     * @param c   The source container whose data will be copied and sorted.
+     * @param c   The source container whose sorted index will be shared.
      * @return    A pair {begin, end} of DescendingOrder iterators.
      */
     static std::pair<DescendingOrder, DescendingOrder> make(const MyContainer<T>& c) {
-        std::vector<T> v = c.getData();              /** Copy elements from the source container. */
-        std::sort(v.begin(), v.end(), std::greater<T>()); /**  Sort in descending order. */
+        EX4_TRACE_SPAN("DescendingOrder::make");
+        EX4_STATS(OrderStats& st = c.statsSink().order(OrderKind::Descending);)
+        EX4_STATS(ScopedLatency timer(st.makeLatency);)
+        EX4_STATS(++st.snapshots;)
+        EX4_STATS(const bool cold = !c.isIndexWarm();)
+        auto v = c.sortedSnapshot();                 /** Cached ascending index, read backwards. */
+        EX4_STATS(if (cold) { ++st.sorts; c.statsSink().recordCopy(OrderKind::Descending, v->size() * sizeof(T)); })
         return {
             DescendingOrder(v, 0),                   /**  Iterator pointing to the first (largest) element. */
-            DescendingOrder(v, v.size())             /**  Iterator pointing one past the last element. */
+            DescendingOrder(v, v->size())            /**  Iterator pointing one past the last element. */
         };
     }
 
@@ -52,14 +63,14 @@ public:
      * @return A constant reference to the element currently pointed to by the iterator.
      * @throws std::out_of_range if the iterator index is invalid (guarded via `vector::at`).
      */
-    const T& operator*() const { return view.at(idx); }
+    const T& operator*() const { return view->at(position()); }
 
     /**
      * @brief Arrow operator providing pointer-like access to members of the current element.
      * @return A pointer to the current element in the `view`.
      * @throws std::out_of_range if the index is invalid (guarded via `vector::at`).
      */
-    const T* operator->() const { return &view.at(idx); }
+    const T* operator->() const { return &view->at(position()); }
 
     /**
      * @brief Prefix increment operator (advances first, then returns this iterator).
@@ -77,13 +88,39 @@ public:
         return tmp;                  /** Return the saved copy. */
     }
 
+    /**
+     * @brief Copy up to `n` elements from the current position into `out`, then advance past them.
+     * @param out Caller buffer with room for at least `n` elements.
+     * @param n   Maximum number of elements to copy.
+     * @return Number of elements written (0 once the end is reached).
+     *
+     * The block is contiguous in the sorted view and is copied in reverse in one pass.
+     */
+    std::size_t next_batch(T* out, std::size_t n) {
+        const std::size_t k = copy_to(out, n);
+        idx += k;
+        return k;
+    }
+
+    /**
+     * @brief Same as `next_batch` but leaves the iterator where it is.
+     * @return Number of elements written.
+     */
+    std::size_t copy_to(T* out, std::size_t n) const {
+        const std::size_t size = view->size();
+        const std::size_t k = std::min(n, size - std::min(idx, size));
+        const T* last = view->data() + (size - std::min(idx, size));
+        std::reverse_copy(last - k, last, out);              /** Contiguous block, written back to front. */
+        return k;
+    }
+
     /**
      * @brief Equality comparison operator.
      * @param other Another DescendingOrder iterator.
      * @return true if both iterators refer to the same view and index.
      */
     bool operator==(const DescendingOrder& other) const {
-        return idx == other.idx && view == other.view;
+        return idx == other.idx && (view == other.view || *view == *other.view);
     }
 
     /**
@@ -1,6 +1,10 @@
 #pragma once
 #include <vector>   
+#include <memory>   
+#include <algorithm>
 #include <cstddef>  
+#include "../Instrumentation/Stats.hpp"
+#include "../Instrumentation/Trace.hpp"
 
 namespace ex4 { 
 
@@ -13,22 +17,42 @@ template <typename T> class MyContainer;
  * - Starts from the middle element of the container.
  * - Then alternates moving left and right from the center, visiting elements outward.
  * - Continues until all elements have been visited.
+ * - Shares the container's insertion-order snapshot; the sequence is computed from `idx` on the fly.
  * 
  */
 template <typename T>
 class MiddleOutOrder {
-    std::vector<T> view;  /** Local view of the container's elements arranged in middle-out order. */
+    std::shared_ptr<const std::vector<T>> view;  /** Shared snapshot of the container's elements in insertion order. */
     std::size_t idx;      /** Current traversal index (0..view.size()). */
 
+    /**
+     * @brief Map the traversal position to a position in the insertion-order view.
+     *
+     * With mid = (n-1)/2 (lower middle), step 0 is mid; for steps up to 2*mid the sides
+     * alternate (odd → mid - s, even → mid + s with s = (i+1)/2). The left side is then
+     * exhausted, and the remaining right-side elements follow in order (position == i).
+     * @param i Traversal position (the iterator's own `idx` by default).
+     * @return Position in `view`, out of range once `i` reaches the end.
+     */
+    std::size_t position(std::size_t i) const {
+        const std::size_t n = view->size();
+        if (i >= n) return n;
+        const std::size_t mid = (n - 1) / 2;
+        if (i > 2 * mid) return i;
+        const std::size_t step = (i + 1) / 2;
+        return (i % 2 == 1) ? mid - step : mid + step;
+    }
+    std::size_t position() const { return position(idx); }
+
 public:
     /**
      * @brief Constructs an iterator using a prepared traversal view and starting position.
-     * @param v  Vector representing the traversal order of elements.
+     * @param v  Shared insertion-order snapshot.
      * @param i  Starting index (defaults to 0 for begin, `view.size()` for end).
      *
      */
-    MiddleOutOrder(std::vector<T> v, std::size_t i = 0)
-        : view(std::move(v)),  /** Move-construct the local traversal view. */
+    MiddleOutOrder(std::shared_ptr<const std::vector<T>> v, std::size_t i = 0)
+        : view(std::move(v)),  /** Take over the reference without copying elements. */
           idx(i)               /** Initialize traversal index. */
     {}
 
@@ -38,40 +62,14 @@ public:
      * @return   A pair {begin, end} representing the start and end iterators.
      */
     static std::pair<MiddleOutOrder, MiddleOutOrder> make(const MyContainer<T>& c) {
-        const std::vector<T>& base = c.getData();      /**  Retrieve the base data. */
-        const std::size_t n = base.size();             /** Number of elements in the container. */
-        std::vector<T> seq;                            /** Sequence to hold the middle-out traversal. */
-        seq.reserve(n);                                /** Reserve space to avoid reallocations. */
-
-        if (n == 0)
-            return { MiddleOutOrder(seq, 0), MiddleOutOrder(seq, 0) }; /** Empty container → both begin and end are same. */
-
-        long mid   = static_cast<long>((n - 1) / 2);   /**  Compute middle index (lower middle if even). */
-        long left  = mid - 1;                          /**  Initialize left pointer one step before middle. */
-        long right = mid + 1;                          /**  Initialize right pointer one step after middle. */
-
-        seq.push_back(base[static_cast<std::size_t>(mid)]); /**  Start with the middle element. */
-
-        bool take_left = true;                         /** Flag to alternate between left and right sides. */
-
-        while (seq.size() < n) {
-            if (take_left && left >= 0) {              /** Take from left if available. */
-                seq.push_back(base[static_cast<std::size_t>(left--)]);
-            } else if (!take_left && right < static_cast<long>(n)) { /** Take from right if available. */
-                seq.push_back(base[static_cast<std::size_t>(right++)]);
-            }
-
-            if (left < 0)
-                take_left = false;                     /** No more left elements → only take from right. */
-            else if (right >= static_cast<long>(n))
-                take_left = true;                      /** No more right elements → only take from left. */
-            else
-                take_left = !take_left;                /** Otherwise, continue alternating sides. */
-        }
-
+        EX4_TRACE_SPAN("MiddleOutOrder::make");
+        EX4_STATS(OrderStats& st = c.statsSink().order(OrderKind::MiddleOut);)
+        EX4_STATS(ScopedLatency timer(st.makeLatency);)
+        EX4_STATS(++st.snapshots;)
+        auto base = c.snapshot();                      /** Share container storage (no copy). */
         return {
-            MiddleOutOrder(seq, 0),                    /** Begin iterator (first element). */
-            MiddleOutOrder(seq, seq.size())            /** End iterator (one past last element). */
+            MiddleOutOrder(base, 0),                   /** Begin iterator (middle element). */
+            MiddleOutOrder(base, base->size())         /** End iterator (one past last element). */
         };
     }
 
@@ -81,7 +79,7 @@ public:
      * @throws std::out_of_range if `idx` is not a valid index (checked via `std::vector::at`).
      *
      */
-    const T& operator*() const { return view.at(idx); }
+    const T& operator*() const { return view->at(position()); }
 
     /**
      * @brief Arrow operator for pointer-like access to members of the element.
@@ -89,7 +87,7 @@ public:
      * @throws std::out_of_range if `idx` is invalid (checked via `at`).
      *
      */
-    const T* operator->() const { return &view.at(idx); }
+    const T* operator->() const { return &view->at(position()); }
 
     /**
      * @brief Prefix increment operator.
@@ -111,6 +109,32 @@ public:
         return tmp;                 /** Return the old iterator. */
     }
 
+    /**
+     * @brief Copy up to `n` elements from the current position into `out`, then advance past them.
+     * @param out Caller buffer with room for at least `n` elements.
+     * @param n   Maximum number of elements to copy.
+     * @return Number of elements written (0 once the end is reached).
+     *
+     * A tight gather loop over the insertion view replaces per-element `at()` calls.
+     */
+    std::size_t next_batch(T* out, std::size_t n) {
+        const std::size_t k = copy_to(out, n);
+        idx += k;
+        return k;
+    }
+
+    /**
+     * @brief Same as `next_batch` but leaves the iterator where it is.
+     * @return Number of elements written.
+     */
+    std::size_t copy_to(T* out, std::size_t n) const {
+        const std::size_t size = view->size();
+        const std::size_t k = std::min(n, size - std::min(idx, size));
+        const T* v = view->data();
+        for (std::size_t j = 0; j < k; ++j) out[j] = v[position(idx + j)];  /** Gather, no bounds checks. */
+        return k;
+    }
+
     /**
      * @brief Equality comparison operator.
      * @param other Another MiddleOutOrder iterator.
@@ -119,7 +143,7 @@ public:
      * Used in loop termination (e.g., `for (it != end)`).
      */
     bool operator==(const MiddleOutOrder& other) const {
-        return idx == other.idx && view == other.view;
+        return idx == other.idx && (view == other.view || *view == *other.view);
     }
 
     /**
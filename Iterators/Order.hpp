@@ -1,6 +1,10 @@
 #pragma once
 #include <vector>   
+#include <memory>   
+#include <algorithm>
 #include <cstddef>   
+#include "../Instrumentation/Stats.hpp"
+#include "../Instrumentation/Trace.hpp"
 
 namespace ex4 {     
 
@@ -11,24 +15,25 @@ namespace ex4 {
  * @brief A simple iterator that traverses elements in the order they were originally inserted.
  *
  * Overview:
- *  - This iterator is essentially a lightweight wrapper around a vector copy (`view`) of the container’s data.
+ *  - This iterator is a lightweight wrapper around a shared, immutable snapshot (`view`) of the container’s data.
+ *  - The snapshot is the container's own copy-on-write storage, so building the iterator copies nothing.
  *  - The traversal order is identical to the insertion order.
  *  - Maintains a single index (`idx`) pointing to the current position.
  *  - Implements basic forward-iteration behavior: dereference, prefix/postfix ++, equality/inequality.
  */
 template <typename T>
 class Order {
-    std::vector<T> view;  /** Local copy of container elements in insertion order. */
+    std::shared_ptr<const std::vector<T>> view;  /** Shared snapshot of container elements in insertion order. */
     std::size_t idx;      /** Current position index within the view (0..view.size()). */
 
 public:
     /**
      * @brief Constructor initializing the iterator with a given view and start index.
-     * @param v  A vector representing the elements to iterate over.
+     * @param v  Shared snapshot of the elements to iterate over.
      * @param i  Starting index (defaults to 0).
      */
-    Order(std::vector<T> v, std::size_t i = 0)
-        : view(std::move(v)),  /** Move-construct local view to avoid unnecessary copying. */
+    Order(std::shared_ptr<const std::vector<T>> v, std::size_t i = 0)
+        : view(std::move(v)),  /** Take over the reference without copying elements. */
           idx(i)               /** Initialize the current index. */
     {}
 
@@ -39,10 +44,14 @@ public:
      *
      */
     static std::pair<Order, Order> make(const MyContainer<T>& c) {
-        std::vector<T> v = c.getData();          /** Copy container elements in their original order. */
+        EX4_TRACE_SPAN("Order::make");
+        EX4_STATS(OrderStats& st = c.statsSink().order(OrderKind::Insertion);)
+        EX4_STATS(ScopedLatency timer(st.makeLatency);)
+        EX4_STATS(++st.snapshots;)
+        auto v = c.snapshot();                   /** Share container storage (no copy). */
         return { 
             Order(v, 0),                         /** Begin iterator (first element). */
-            Order(v, v.size())                   /** End iterator (past last element). */
+            Order(v, v->size())                  /** End iterator (past last element). */
         };
     }
 
@@ -52,7 +61,7 @@ public:
      * @throws std::out_of_range if the index is invalid (guarded by `vector::at`).
      *
      */
-    const T& operator*() const { return view.at(idx); }
+    const T& operator*() const { return view->at(idx); }
 
     /**
      * @brief Arrow operator providing pointer-style access to the current element.
@@ -64,7 +73,7 @@ public:
      *  it->someMethod(); // if T is a class with methods
      *  @endcode
      */
-    const T* operator->() const { return &view.at(idx); }
+    const T* operator->() const { return &view->at(idx); }
 
     /**
      * @brief Prefix increment operator.
@@ -86,14 +95,41 @@ public:
         return tmp;          /** Return saved iterator. */
     }
 
+    /**
+     * @brief Copy up to `n` elements from the current position into `out`, then advance past them.
+     * @param out Caller buffer with room for at least `n` elements.
+     * @param n   Maximum number of elements to copy.
+     * @return Number of elements written (0 once the end is reached).
+     *
+     * Insertion order is contiguous in the view, so this is one block copy.
+     */
+    std::size_t next_batch(T* out, std::size_t n) {
+        const std::size_t k = copy_to(out, n);
+        idx += k;
+        return k;
+    }
+
+    /**
+     * @brief Same as `next_batch` but leaves the iterator where it is.
+     * @return Number of elements written.
+     */
+    std::size_t copy_to(T* out, std::size_t n) const {
+        const std::size_t size = view->size();
+        const std::size_t from = std::min(idx, size);          /** Past-the-end iterators copy nothing. */
+        const std::size_t k = std::min(n, size - from);
+        std::copy_n(view->data() + from, k, out);             /** Contiguous: memcpy for trivially copyable T. */
+        return k;
+    }
+
     /**
      * @brief Equality comparison operator.
      * @param other Another Order iterator.
-     * @return true if both iterators refer to the same view and same position.
+     * @return true if both iterators refer to equal views and the same position.
      *
+     * Iterators from the same snapshot compare by pointer; different snapshots fall back to contents.
      */
     bool operator==(const Order& other) const {
-        return idx == other.idx && view == other.view;
+        return idx == other.idx && (view == other.view || *view == *other.view);
     }
 
     /**
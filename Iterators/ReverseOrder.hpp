@@ -1,7 +1,10 @@
 #pragma once
 #include <vector>    
+#include <memory>    
 #include <algorithm> 
 #include <cstddef>   
+#include "../Instrumentation/Stats.hpp"
+#include "../Instrumentation/Trace.hpp"
 
 namespace ex4 {      
 /** Forward declaration to reference MyContainer<T> without including its full definition. */
@@ -12,25 +15,28 @@ template <typename T> class MyContainer;
  * @brief Iterator that traverses a container’s elements in reverse order.
  *
  * Overview:
- *  - Builds a reversed copy of the container’s contents (`view`).
- *  - Maintains a current index (`idx`) representing traversal position.
+ *  - Shares the container’s insertion-order snapshot (`view`) and reads it back to front.
+ *  - Maintains a current index (`idx`) representing traversal position (0 = last inserted element).
  *  - Provides prefix/postfix increment, dereference, and comparison operators.
  *
  */
 template <typename T>
 class ReverseOrder {
-    std::vector<T> view;  /** Local copy of container elements, reversed. */
+    std::shared_ptr<const std::vector<T>> view;  /** Shared snapshot in insertion order (read backwards). */
     std::size_t idx;      /** Current traversal position (0..view.size()). */
 
+    /** @return Position in `view` of the current element (out of range once `idx` reaches the end). */
+    std::size_t position() const { return view->size() - 1 - idx; }
+
 public:
     /**
      * @brief Constructs an iterator with a prepared view and starting index.
-     * @param v  Vector representing traversal order (already reversed).
+     * @param v  Shared insertion-order snapshot (traversed from the back).
      * @param i  Starting index (default = 0 for begin).
      *
-     * Uses move semantics for efficient transfer of data.
+     * Uses move semantics for efficient transfer of the reference.
      */
-    ReverseOrder(std::vector<T> v, std::size_t i = 0)
+    ReverseOrder(std::shared_ptr<const std::vector<T>> v, std::size_t i = 0)
         : view(std::move(v)),  /** Move constructor for efficiency. */
           idx(i)               /** Initialize iterator position. */
     {}
@@ -42,11 +48,14 @@ public:
      *
      */
     static std::pair<ReverseOrder, ReverseOrder> make(const MyContainer<T>& c) {
-        std::vector<T> v = c.getData();          /** Copy original data. */
-        std::reverse(v.begin(), v.end());        /** Reverse the entire vector in place. */
+        EX4_TRACE_SPAN("ReverseOrder::make");
+        EX4_STATS(OrderStats& st = c.statsSink().order(OrderKind::Reverse);)
+        EX4_STATS(ScopedLatency timer(st.makeLatency);)
+        EX4_STATS(++st.snapshots;)
+        auto v = c.snapshot();                   /** Share container storage (no copy, no reversal). */
         return {
-            ReverseOrder(v, 0),                  /** Begin iterator (first element of reversed vector). */
-            ReverseOrder(v, v.size())            /** End iterator (one past the last element). */
+            ReverseOrder(v, 0),                  /** Begin iterator (last inserted element). */
+            ReverseOrder(v, v->size())           /** End iterator (one past the first inserted element). */
         };
     }
 
@@ -61,7 +70,7 @@ public:
      *  std::cout << *it;
      *  @endcode
      */
-    const T& operator*() const { return view.at(idx); }
+    const T& operator*() const { return view->at(position()); }
 
     /**
      * @brief Arrow operator providing pointer-like access.
@@ -73,7 +82,7 @@ public:
      *  it->someMethod(); // if T is a class with members
      *  @endcode
      */
-    const T* operator->() const { return &view.at(idx); }
+    const T* operator->() const { return &view->at(position()); }
 
     /**
      * @brief Prefix increment operator.
@@ -97,6 +106,32 @@ public:
         return tmp;                /** Return saved version. */
     }
 
+    /**
+     * @brief Copy up to `n` elements from the current position into `out`, then advance past them.
+     * @param out Caller buffer with room for at least `n` elements.
+     * @param n   Maximum number of elements to copy.
+     * @return Number of elements written (0 once the end is reached).
+     *
+     * The block is contiguous in the view and is copied in reverse in one pass.
+     */
+    std::size_t next_batch(T* out, std::size_t n) {
+        const std::size_t k = copy_to(out, n);
+        idx += k;
+        return k;
+    }
+
+    /**
+     * @brief Same as `next_batch` but leaves the iterator where it is.
+     * @return Number of elements written.
+     */
+    std::size_t copy_to(T* out, std::size_t n) const {
+        const std::size_t size = view->size();
+        const std::size_t k = std::min(n, size - std::min(idx, size));
+        const T* last = view->data() + (size - std::min(idx, size));
+        std::reverse_copy(last - k, last, out);              /** Contiguous block, written back to front. */
+        return k;
+    }
+
     /**
      * @brief Equality comparison operator.
      * @param other Another ReverseOrder iterator.
@@ -105,7 +140,7 @@ public:
      * Commonly used for loop termination: `while (it != end)`.
      */
     bool operator==(const ReverseOrder& other) const {
-        return idx == other.idx && view == other.view;
+        return idx == other.idx && (view == other.view || *view == *other.view);
     }
 
     /**
@@ -1,7 +1,10 @@
 #pragma once
 #include <vector>     
+#include <memory>     
 #include <algorithm>  
 #include <cstddef>    
+#include "../Instrumentation/Stats.hpp"
+#include "../Instrumentation/Trace.hpp"
 
 namespace ex4 {    
 
@@ -19,18 +22,31 @@ template <typename T> class MyContainer;
  */
 template <typename T>
 class SideCrossOrder {
-    std::vector<T> view;  /** Local traversal view in side-cross order. */
+    std::shared_ptr<const std::vector<T>> view;  /** Shared snapshot sorted in ascending order. */
     std::size_t idx;      /** Current traversal position (0..view.size()). */
 
+    /**
+     * @brief Map the traversal position to a position in the ascending view.
+     * @param i Traversal position (the iterator's own `idx` by default).
+     * @return Even steps take from the low end (i/2), odd steps from the high end (n-1-i/2);
+     *         out of range once `i` reaches the end.
+     */
+    std::size_t position(std::size_t i) const {
+        const std::size_t n = view->size();
+        if (i >= n) return n;
+        return (i % 2 == 0) ? i / 2 : n - 1 - i / 2;
+    }
+    std::size_t position() const { return position(idx); }
+
 public:
     /**
      * @brief Constructor initializing the iterator with a traversal view and start index.
-     * @param v  Vector of elements representing traversal order.
+     * @param v  Ascending sorted view; the side-cross sequence is computed from it on the fly.
      * @param i  Starting index (default = 0 for begin).
      *
      * Moves `v` into the iterator for efficiency (no deep copy).
      */
-    SideCrossOrder(std::vector<T> v, std::size_t i = 0)
+    SideCrossOrder(std::shared_ptr<const std::vector<T>> v, std::size_t i = 0)
         : view(std::move(v)),  /** Move-construct local traversal view. */
           idx(i)               /** Initialize iterator position. */
     {}
@@ -41,41 +57,24 @@ public:
      * @return   A pair {begin, end} of SideCrossOrder iterators.
      *
      * Steps:
-     *  1) Copy the container’s data.
-     *  2) Sort it in ascending order.
-     *  3) Initialize two indices:
-     *       - i → beginning (lowest value)
-     *       - j → end (highest value)
-     *  4) Alternate pushing elements from low and high ends into a result vector.
-     *  5) Stop when all elements have been included.
+     *  1) Share the container's cached ascending index (sorted only when cold).
+     *  2) Step k maps to sorted[k/2] for even k (low end) and sorted[n-1-k/2] for odd k (high end),
+     *     so the alternating sequence is never materialized.
      *
-     * Time Complexity: O(n log n) (due to sorting)
-     * Space Complexity: O(n) for the traversal vector.
+     * Time Complexity: O(1) with a warm index, O(n log n) otherwise.
+     * Space Complexity: O(1) beyond the shared index.
      */
     static std::pair<SideCrossOrder, SideCrossOrder> make(const MyContainer<T>& c) {
-        std::vector<T> sorted = c.getData();           /** 1) Copy all elements from the source container. */
-        std::sort(sorted.begin(), sorted.end());       /** 2) Sort ascending. */
-
-        std::vector<T> seq;                            /** Vector to store the final traversal order. */
-        seq.reserve(sorted.size());                    /** Reserve space for efficiency. */
-
-        std::size_t i = 0;                             /** 3a) Left (low) index. */
-        std::size_t j = sorted.size() ? sorted.size() - 1 : 0; /** 3b) Right (high) index (handle empty case). */
-        bool take_low = true;                          /** 4) Flag controlling which side to take from. */
-
-        /** 5) Alternate between low and high until indices meet. */
-        while (!sorted.empty() && i <= j) {
-            if (take_low)
-                seq.push_back(sorted[i++]);            /** Take from the low end (ascending). */
-            else
-                seq.push_back(sorted[j--]);            /** Take from the high end (descending). */
-            take_low = !take_low;                      /** Flip the flag for next iteration. */
-        }
-
-        /** 6) Return begin/end iterator pair built from the resulting sequence. */
+        EX4_TRACE_SPAN("SideCrossOrder::make");
+        EX4_STATS(OrderStats& st = c.statsSink().order(OrderKind::SideCross);)
+        EX4_STATS(ScopedLatency timer(st.makeLatency);)
+        EX4_STATS(++st.snapshots;)
+        EX4_STATS(const bool cold = !c.isIndexWarm();)
+        auto sorted = c.sortedSnapshot();              /** Cached ascending index. */
+        EX4_STATS(if (cold) { ++st.sorts; c.statsSink().recordCopy(OrderKind::SideCross, sorted->size() * sizeof(T)); })
         return {
-            SideCrossOrder(seq, 0),                    /** Begin iterator (first element). */
-            SideCrossOrder(seq, seq.size())            /** End iterator (one past the last). */
+            SideCrossOrder(sorted, 0),                 /** Begin iterator (smallest element). */
+            SideCrossOrder(sorted, sorted->size())     /** End iterator (one past the last). */
         };
     }
 
@@ -85,7 +84,7 @@ public:
      * @throws std::out_of_range if the index is invalid (checked via `vector::at`).
      *
      */
-    const T& operator*() const { return view.at(idx); }
+    const T& operator*() const { return view->at(position()); }
 
     /**
      * @brief Arrow operator providing pointer-style access.
@@ -94,7 +93,7 @@ public:
      *
      * Enables syntax like `it->member`.
      */
-    const T* operator->() const { return &view.at(idx); }
+    const T* operator->() const { return &view->at(position()); }
 
     /**
      * @brief Prefix increment operator.
@@ -122,10 +121,36 @@ public:
         return tmp;                 /** Return saved iterator. */
     }
 
+    /**
+     * @brief Copy up to `n` elements from the current position into `out`, then advance past them.
+     * @param out Caller buffer with room for at least `n` elements.
+     * @param n   Maximum number of elements to copy.
+     * @return Number of elements written (0 once the end is reached).
+     *
+     * A tight gather loop over the sorted view replaces per-element `at()` calls.
+     */
+    std::size_t next_batch(T* out, std::size_t n) {
+        const std::size_t k = copy_to(out, n);
+        idx += k;
+        return k;
+    }
+
+    /**
+     * @brief Same as `next_batch` but leaves the iterator where it is.
+     * @return Number of elements written.
+     */
+    std::size_t copy_to(T* out, std::size_t n) const {
+        const std::size_t size = view->size();
+        const std::size_t k = std::min(n, size - std::min(idx, size));
+        const T* v = view->data();
+        for (std::size_t j = 0; j < k; ++j) out[j] = v[position(idx + j)];  /** Gather, no bounds checks. */
+        return k;
+    }
+
     /**
      * @brief Equality comparison operator.
      * @param other Another SideCrossOrder iterator.
-     * @return true if both iterators refer to the same view and index.
+     * @return true if both iterators refer to equal views and the same index.
      *
      * Used for loop termination conditions like:
      *  @code
@@ -133,7 +158,7 @@ public:
      *  @endcode
      */
     bool operator==(const SideCrossOrder& other) const {
-        return idx == other.idx && view == other.view;
+        return idx == other.idx && (view == other.view || *view == *other.view);
     }
 
     /**
@@ -0,0 +1,116 @@
+#pragma once
+#include <vector>
+#include <type_traits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "SimdReduce.hpp"
+
+namespace ex4 {
+
+namespace simd_detail {
+
+/**
+ * Equal-width bucketing of [lo, hi]: bucket = (x*shrink - lo*shrink) / width * buckets, the top
+ * edge in the last bucket. When hi - lo overflows (e.g. [-1e308, 1e308]) both operands are
+ * halved first (shrink = 0.5), which keeps every step finite. The index is clamped before the
+ * integer conversion, and a NaN quotient (only possible with an infinite bound) goes to the
+ * last bucket instead of being converted.
+ */
+struct BucketMap {
+    double lo;
+    double hi;
+    double shrink;
+    double width;               /** (hi - lo) * shrink, or 1 for a single-point range. */
+    double count;               /** Number of buckets as a double. */
+    std::size_t last;
+
+    BucketMap(double l, double h, std::size_t buckets)
+        : lo(l), hi(h), shrink(std::isfinite(h - l) ? 1.0 : 0.5),
+          width(h > l ? h * shrink - l * shrink : 1.0), count(static_cast<double>(buckets)), last(buckets - 1) {}
+
+    /** @brief Count `x` into `counts` if it lies in [lo, hi] (NaN never does). */
+    void add(double x, std::size_t* counts) const {
+        if (!(x >= lo && x <= hi)) return;
+        const double q = (x * shrink - lo * shrink) / width * count;
+        ++counts[q < static_cast<double>(last) ? static_cast<std::size_t>(q) : last];
+    }
+};
+
+template <typename T>
+void histogramScalar(const T* p, std::size_t n, const BucketMap& map, std::size_t* counts) {
+    for (std::size_t i = 0; i < n; ++i) map.add(static_cast<double>(p[i]), counts);
+}
+
+#if defined(EX4_SIMD_X86)
+
+/**
+ * Four elements per step: conversion, range test and bucket arithmetic run in double lanes
+ * (the same operations as BucketMap::add, so both paths agree bit for bit). Out-of-range
+ * lanes go to a spare slot instead of branching, and lane j counts into its own table, so
+ * neighbouring increments of one bucket do not serialize.
+ */
+template <typename T>
+EX4_TARGET_AVX2 void histogramAvx2(const T* p, std::size_t n, const BucketMap& map, std::size_t* counts) {
+    const std::size_t stride = map.last + 2;                   /** Buckets plus one slot for out-of-range values. */
+    std::vector<std::size_t> lanes(4 * stride, 0);
+    std::size_t* t0 = lanes.data();
+    std::size_t* t1 = t0 + stride;
+    std::size_t* t2 = t1 + stride;
+    std::size_t* t3 = t2 + stride;
+    const __m256d lo = _mm256_set1_pd(map.lo);
+    const __m256d hi = _mm256_set1_pd(map.hi);
+    const __m256d shrink = _mm256_set1_pd(map.shrink);
+    const __m256d loShrunk = _mm256_set1_pd(map.lo * map.shrink);
+    const __m256d width = _mm256_set1_pd(map.width);
+    const __m256d count = _mm256_set1_pd(map.count);
+    const __m256d last = _mm256_set1_pd(static_cast<double>(map.last));
+    const __m256d skip = _mm256_set1_pd(static_cast<double>(map.last + 1));
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d x = load4pd(p + i);
+        const __m256d inRange = _mm256_and_pd(_mm256_cmp_pd(x, lo, _CMP_GE_OQ), _mm256_cmp_pd(x, hi, _CMP_LE_OQ));
+        const __m256d q = _mm256_mul_pd(_mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(x, shrink), loShrunk), width), count);
+        const __m256d b = _mm256_min_pd(_mm256_floor_pd(q), last);  /** NaN picks `last`, like the scalar path. */
+        const __m128i idx = _mm256_cvttpd_epi32(_mm256_blendv_pd(skip, b, inRange));
+        ++t0[static_cast<std::uint32_t>(_mm_cvtsi128_si32(idx))];
+        ++t1[static_cast<std::uint32_t>(_mm_extract_epi32(idx, 1))];
+        ++t2[static_cast<std::uint32_t>(_mm_extract_epi32(idx, 2))];
+        ++t3[static_cast<std::uint32_t>(_mm_extract_epi32(idx, 3))];
+    }
+    for (std::size_t b = 0; b <= map.last; ++b) counts[b] += t0[b] + t1[b] + t2[b] + t3[b];
+    histogramScalar(p + i, n - i, map, counts);
+}
+
+#endif
+
+}
+
+/**
+ * @brief Equal-width histogram of p[0, n) over [lo, hi].
+ * @param buckets Number of buckets (> 0); bucket k covers [lo + k*w, lo + (k+1)*w) with
+ *                w = (hi - lo) / buckets, and the last one also holds `hi`.
+ * @return Counts per bucket; values outside [lo, hi] (and NaN) are not counted.
+ * Complexity: O(n + buckets), one pass, four elements per step with AVX2.
+ */
+template <typename T>
+std::vector<std::size_t> histogramOf(const T* p, std::size_t n, double lo, double hi, std::size_t buckets,
+                                     SimdLevel level = detectSimdLevel()) {
+    static_assert(std::is_arithmetic_v<T>, "histogramOf requires an arithmetic element type");
+    std::vector<std::size_t> counts(buckets, 0);
+    if (buckets == 0) return counts;
+    const simd_detail::BucketMap map(lo, hi, buckets);
+#if defined(EX4_SIMD_X86)
+    if constexpr (simd_detail::kDoubleLanes<T>) {
+        if (level == SimdLevel::AVX2 && buckets < INT32_MAX) {
+            simd_detail::histogramAvx2(p, n, map, counts.data());
+            return counts;
+        }
+    }
+#endif
+    (void)level;
+    simd_detail::histogramScalar(p, n, map, counts.data());
+    return counts;
+}
+
+}
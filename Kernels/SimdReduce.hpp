@@ -0,0 +1,333 @@
+#pragma once
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include "SimdScan.hpp"
+
+namespace ex4 {
+
+/**
+ * @brief Result type of sumOf: double (long double) for floating-point T, a 64-bit integer
+ *        of T's signedness for integral T, T itself otherwise (never instantiated then).
+ */
+template <typename T>
+using SumType = std::conditional_t<std::is_floating_point_v<T>,
+                                   std::conditional_t<std::is_same_v<T, long double>, long double, double>,
+                std::conditional_t<std::is_integral_v<T>,
+                                   std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>, T>>;
+
+/**
+ * @brief Neumaier (improved Kahan) running sum in F: `carry` collects the low-order bits lost
+ *        by each addition, so the error stays O(eps) instead of O(n eps).
+ */
+template <typename F = double>
+struct CompensatedSum {
+    F sum = 0;
+    F carry = 0;
+
+    void add(F x) {
+        const F t = sum + x;
+        carry += std::fabs(sum) >= std::fabs(x) ? (sum - t) + x : (x - t) + sum;
+        sum = t;
+    }
+    void merge(const CompensatedSum& other) {
+        add(other.sum);
+        carry += other.carry;
+    }
+    F value() const { return sum + carry; }
+};
+
+/** Partial sums of a deviation pass: sum of (x - mean) and of (x - mean)^2. */
+struct DeviationSums {
+    CompensatedSum<> linear;
+    CompensatedSum<> squares;
+
+    void merge(const DeviationSums& other) {
+        linear.merge(other.linear);
+        squares.merge(other.squares);
+    }
+};
+
+namespace simd_detail {
+
+/** Element types the AVX2 reductions load four at a time as doubles. */
+template <typename T>
+constexpr bool kDoubleLanes = std::is_same_v<T, double> || std::is_same_v<T, float> ||
+    (std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+     (sizeof(T) < 4 || (sizeof(T) == 4 && std::is_signed_v<T>)));
+
+/** Integral types the AVX2 exact sum widens four at a time into 64-bit lanes. */
+template <typename T>
+constexpr bool kWideningLanes = std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 4;
+
+/** Compensated sum of floating-point p[0, n) in SumType<T> (long double stays long double). */
+template <typename T>
+CompensatedSum<SumType<T>> sumScalar(const T* p, std::size_t n) {
+    CompensatedSum<SumType<T>> s;
+    for (std::size_t i = 0; i < n; ++i) s.add(static_cast<SumType<T>>(p[i]));
+    return s;
+}
+
+template <typename T>
+SumType<T> sumIntScalar(const T* p, std::size_t n) {
+    SumType<T> s = 0;
+    for (std::size_t i = 0; i < n; ++i) s += static_cast<SumType<T>>(p[i]);
+    return s;
+}
+
+template <typename T>
+DeviationSums deviationsScalar(const T* p, std::size_t n, double mean) {
+    DeviationSums r;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double d = static_cast<double>(p[i]) - mean;
+        r.linear.add(d);
+        r.squares.add(d * d);
+    }
+    return r;
+}
+
+#if defined(EX4_SIMD_X86)
+
+/** @return p[0..3] converted to doubles. */
+template <typename T>
+EX4_TARGET_AVX2 inline __m256d load4pd(const T* p) {
+    if constexpr (std::is_same_v<T, double>) {
+        return _mm256_loadu_pd(p);
+    } else if constexpr (std::is_same_v<T, float>) {
+        return _mm256_cvtps_pd(_mm_loadu_ps(p));
+    } else if constexpr (sizeof(T) == 4) {
+        return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    } else {
+        std::int64_t bits = 0;
+        std::memcpy(&bits, p, 4 * sizeof(T));
+        const __m128i raw = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&bits));
+        if constexpr (sizeof(T) == 2) {
+            return _mm256_cvtepi32_pd(std::is_signed_v<T> ? _mm_cvtepi16_epi32(raw) : _mm_cvtepu16_epi32(raw));
+        } else {
+            return _mm256_cvtepi32_pd(std::is_signed_v<T> ? _mm_cvtepi8_epi32(raw) : _mm_cvtepu8_epi32(raw));
+        }
+    }
+}
+
+/** @return p[0..3] widened to 64-bit integer lanes (sign- or zero-extended). */
+template <typename T>
+EX4_TARGET_AVX2 inline __m256i load4epi64(const T* p) {
+    if constexpr (sizeof(T) == 4) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return std::is_signed_v<T> ? _mm256_cvtepi32_epi64(raw) : _mm256_cvtepu32_epi64(raw);
+    } else {
+        std::int64_t bits = 0;
+        std::memcpy(&bits, p, 4 * sizeof(T));
+        const __m128i raw = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&bits));
+        if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm256_cvtepi16_epi64(raw) : _mm256_cvtepu16_epi64(raw);
+        else return std::is_signed_v<T> ? _mm256_cvtepi8_epi64(raw) : _mm256_cvtepu8_epi64(raw);
+    }
+}
+
+/** @brief Lane-wise Neumaier step: s += x, with the rounding error added to c. */
+EX4_TARGET_AVX2 inline void addCompensated(__m256d& s, __m256d& c, __m256d x) {
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+    const __m256d t = _mm256_add_pd(s, x);
+    const __m256d sBigger = _mm256_cmp_pd(_mm256_and_pd(s, absMask), _mm256_and_pd(x, absMask), _CMP_GE_OQ);
+    const __m256d big = _mm256_blendv_pd(x, s, sBigger);
+    const __m256d small = _mm256_blendv_pd(s, x, sBigger);
+    c = _mm256_add_pd(c, _mm256_add_pd(_mm256_sub_pd(big, t), small));
+    s = t;
+}
+
+/** @brief Fold four lane sums and their carries into `out`. */
+EX4_TARGET_AVX2 inline void foldLanes(CompensatedSum<>& out, __m256d s, __m256d c) {
+    alignas(32) double sums[4], carries[4];
+    _mm256_store_pd(sums, s);
+    _mm256_store_pd(carries, c);
+    for (int j = 0; j < 4; ++j) {
+        out.add(sums[j]);
+        out.carry += carries[j];
+    }
+}
+
+/** Two independent accumulators per pass hide the latency of the dependent adds. */
+template <typename T>
+EX4_TARGET_AVX2 CompensatedSum<> sumAvx2(const T* p, std::size_t n) {
+    __m256d s0 = _mm256_setzero_pd(), c0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd(), c1 = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        addCompensated(s0, c0, load4pd(p + i));
+        addCompensated(s1, c1, load4pd(p + i + 4));
+    }
+    CompensatedSum<> r;
+    foldLanes(r, s0, c0);
+    foldLanes(r, s1, c1);
+    r.merge(sumScalar(p + i, n - i));
+    return r;
+}
+
+template <typename T>
+EX4_TARGET_AVX2 SumType<T> sumIntAvx2(const T* p, std::size_t n) {
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_epi64(acc0, load4epi64(p + i));
+        acc1 = _mm256_add_epi64(acc1, load4epi64(p + i + 4));
+    }
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(acc0, acc1));
+    std::uint64_t s = lanes[0] + lanes[1] + lanes[2] + lanes[3];    /** Two's complement: signedness-agnostic. */
+    for (; i < n; ++i) s += static_cast<std::uint64_t>(static_cast<SumType<T>>(p[i]));
+    return static_cast<SumType<T>>(s);
+}
+
+template <typename T>
+EX4_TARGET_AVX2 DeviationSums deviationsAvx2(const T* p, std::size_t n, double mean) {
+    const __m256d m = _mm256_set1_pd(mean);
+    __m256d ls = _mm256_setzero_pd(), lc = _mm256_setzero_pd();
+    __m256d qs = _mm256_setzero_pd(), qc = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d d = _mm256_sub_pd(load4pd(p + i), m);
+        addCompensated(ls, lc, d);
+        addCompensated(qs, qc, _mm256_mul_pd(d, d));
+    }
+    DeviationSums r;
+    foldLanes(r.linear, ls, lc);
+    foldLanes(r.squares, qs, qc);
+    r.merge(deviationsScalar(p + i, n - i, mean));
+    return r;
+}
+
+#endif
+
+/** Smallest chunk worth a thread of its own. */
+constexpr std::size_t kMinParallelChunk = std::size_t{1} << 16;
+
+/**
+ * @brief Split [0, n) into up to `threads` chunks, reduce each with `chunk(first, count)`
+ *        (the caller's thread takes the first one) and fold the results in order with `merge`.
+ * @param threads 0 = one per hardware thread; the count is capped so chunks stay large.
+ */
+template <typename R, typename Chunk, typename Merge>
+R parallelReduce(std::size_t n, std::size_t threads, Chunk chunk, Merge merge) {
+    if (threads == 0) threads = std::max(1U, std::thread::hardware_concurrency());
+    threads = std::min(threads, std::max<std::size_t>(1, n / kMinParallelChunk));
+    if (threads <= 1) return chunk(std::size_t{0}, n);
+
+    std::vector<R> partial(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    const std::size_t step = n / threads;
+    try {
+        for (std::size_t t = 1; t < threads; ++t) {
+            const std::size_t first = t * step;
+            const std::size_t count = t + 1 == threads ? n - first : step;
+            workers.emplace_back([&, t, first, count] { partial[t] = chunk(first, count); });
+        }
+        partial[0] = chunk(std::size_t{0}, step);
+    } catch (...) {
+        for (auto& w : workers) w.join();                   /** A joinable std::thread must not be destroyed. */
+        throw;
+    }
+    for (auto& w : workers) w.join();
+    R result = partial[0];
+    for (std::size_t t = 1; t < threads; ++t) merge(result, partial[t]);
+    return result;
+}
+
+}
+
+/**
+ * @brief Sum of p[0, n).
+ * Integral T is summed exactly in 64 bits (wrapping like the 64-bit type); floating-point T
+ * is summed with compensation in double (long double for long double), so the result does
+ * not drift with n.
+ * @param threads Worker threads for large inputs (1 = caller only, 0 = all hardware threads).
+ * @param level   AVX2 uses vector kernels; any other level runs the portable scalar loop.
+ */
+template <typename T>
+SumType<T> sumOf(const T* p, std::size_t n, std::size_t threads = 1, SimdLevel level = detectSimdLevel()) {
+    static_assert(std::is_arithmetic_v<T>, "sumOf requires an arithmetic element type");
+    if constexpr (std::is_floating_point_v<T>) {
+        auto chunk = [&](std::size_t first, std::size_t count) {
+#if defined(EX4_SIMD_X86)
+            if constexpr (simd_detail::kDoubleLanes<T>) {
+                if (level == SimdLevel::AVX2) return simd_detail::sumAvx2(p + first, count);
+            }
+#endif
+            (void)level;
+            return simd_detail::sumScalar(p + first, count);
+        };
+        using Acc = CompensatedSum<SumType<T>>;
+        auto merge = [](Acc& a, const Acc& b) { a.merge(b); };
+        return simd_detail::parallelReduce<Acc>(n, threads, chunk, merge).value();
+    } else {
+        auto chunk = [&](std::size_t first, std::size_t count) {
+#if defined(EX4_SIMD_X86)
+            if constexpr (simd_detail::kWideningLanes<T>) {
+                if (level == SimdLevel::AVX2) return simd_detail::sumIntAvx2(p + first, count);
+            }
+#endif
+            (void)level;
+            return simd_detail::sumIntScalar(p + first, count);
+        };
+        auto merge = [](SumType<T>& a, const SumType<T>& b) { a += b; };
+        return simd_detail::parallelReduce<SumType<T>>(n, threads, chunk, merge);
+    }
+}
+
+/**
+ * @brief Arithmetic mean of p[0, n) (n > 0). Unlike sumOf it never wraps.
+ * Integral T of at most 32 bits over at most UINT32_MAX elements uses the exact 64-bit sum,
+ * which cannot overflow there; wider integers (or more elements) are summed with compensation
+ * in long double, exact per element where long double has a 64-bit mantissa (x87).
+ */
+template <typename T>
+double meanOf(const T* p, std::size_t n, std::size_t threads = 1, SimdLevel level = detectSimdLevel()) {
+    static_assert(std::is_arithmetic_v<T>, "meanOf requires an arithmetic element type");
+    if constexpr (std::is_integral_v<T>) {
+        if (sizeof(T) > 4 || n > UINT32_MAX) {
+            using Acc = CompensatedSum<long double>;
+            auto chunk = [&](std::size_t first, std::size_t count) {
+                Acc s;
+                for (std::size_t i = first; i < first + count; ++i) s.add(static_cast<long double>(p[i]));
+                return s;
+            };
+            auto merge = [](Acc& a, const Acc& b) { a.merge(b); };
+            const Acc total = simd_detail::parallelReduce<Acc>(n, threads, chunk, merge);
+            return static_cast<double>(total.value() / static_cast<long double>(n));
+        }
+    }
+    return static_cast<double>(sumOf(p, n, threads, level)) / static_cast<double>(n);
+}
+
+/**
+ * @brief Population variance of p[0, n) around `mean` (corrected two-pass formula:
+ *        (sum d^2 - (sum d)^2 / n) / n with d = x - mean, both sums compensated).
+ * @return 0 for n == 0.
+ */
+template <typename T>
+double varianceOf(const T* p, std::size_t n, double mean, std::size_t threads = 1,
+                  SimdLevel level = detectSimdLevel()) {
+    static_assert(std::is_arithmetic_v<T>, "varianceOf requires an arithmetic element type");
+    if (n == 0) return 0.0;
+    auto chunk = [&](std::size_t first, std::size_t count) {
+#if defined(EX4_SIMD_X86)
+        if constexpr (simd_detail::kDoubleLanes<T>) {
+            if (level == SimdLevel::AVX2) return simd_detail::deviationsAvx2(p + first, count, mean);
+        }
+#endif
+        (void)level;
+        return simd_detail::deviationsScalar(p + first, count, mean);
+    };
+    auto merge = [](DeviationSums& a, const DeviationSums& b) { a.merge(b); };
+    const DeviationSums d = simd_detail::parallelReduce<DeviationSums>(n, threads, chunk, merge);
+    const double linear = d.linear.value();
+    const double nd = static_cast<double>(n);
+    return std::max(0.0, (d.squares.value() - linear * linear / nd) / nd);
+}
+
+}
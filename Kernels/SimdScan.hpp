@@ -0,0 +1,352 @@
+#pragma once
+#include <algorithm>
+#include <type_traits>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define EX4_SIMD_X86 1
+#include <immintrin.h>
+#define EX4_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#endif
+
+namespace ex4 {
+
+/**
+ * @brief Element types the vectorized scan kernels handle: arithmetic types (except bool)
+ *        whose `==` is a lane-wise compare of 1, 2, 4 or 8 bytes.
+ */
+template <typename T>
+struct SimdScannable {
+    static constexpr bool enabled = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+                                    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+};
+
+/** Instruction set used by the scan kernels. */
+enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+/** @return "scalar", "sse2" or "avx2". */
+inline const char* toString(SimdLevel l) {
+    switch (l) {
+        case SimdLevel::SSE2: return "sse2";
+        case SimdLevel::AVX2: return "avx2";
+        default:              return "scalar";
+    }
+}
+
+/** @return Best level supported by this CPU (detected once, on first call). */
+inline SimdLevel detectSimdLevel() {
+#if defined(EX4_SIMD_X86)
+    static const SimdLevel level = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") ? SimdLevel::AVX2
+                                 : __builtin_cpu_supports("sse2") ? SimdLevel::SSE2
+                                                                  : SimdLevel::Scalar;
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+namespace simd_detail {
+
+template <typename T>
+std::size_t findScalar(const T* p, std::size_t n, const T& value) {
+    return static_cast<std::size_t>(std::find(p, p + n, value) - p);
+}
+
+template <typename T>
+std::size_t countScalar(const T* p, std::size_t n, const T& value) {
+    return static_cast<std::size_t>(std::count(p, p + n, value));
+}
+
+/** @brief Compact p[from, n) in place, dropping elements equal to `value`. @return New end. */
+template <typename T>
+std::size_t removeScalar(T* p, std::size_t from, std::size_t n, const T& value) {
+    return static_cast<std::size_t>(std::remove(p + from, p + n, value) - p);
+}
+
+#if defined(EX4_SIMD_X86)
+
+/**
+ * Compress table for 8 lanes of 4 bytes: row `m` lists the lanes whose bit is set in `m`,
+ * in order, so `_mm256_permutevar8x32_epi32(v, row)` packs the kept lanes to the front.
+ */
+struct CompressTable {
+    alignas(32) std::uint32_t lanes[256][8];
+    constexpr CompressTable() : lanes{} {
+        for (unsigned m = 0; m < 256; ++m) {
+            unsigned k = 0;
+            for (unsigned j = 0; j < 8; ++j) {
+                if (m & (1U << j)) lanes[m][k++] = j;
+            }
+            for (; k < 8; ++k) lanes[m][k] = 0;
+        }
+    }
+};
+
+inline const CompressTable& compressTable() {
+    static constexpr CompressTable table{};
+    return table;
+}
+
+/** @return Each bit of the 4-bit mask `m` doubled (8-byte lanes seen as pairs of 4-byte lanes). */
+inline unsigned widenMask4(unsigned m) {
+    unsigned w = 0;
+    for (unsigned j = 0; j < 4; ++j) {
+        if (m & (1U << j)) w |= 3U << (2 * j);
+    }
+    return w;
+}
+
+/** @return Unsigned integer as wide as one lane of T (the per-lane match counters). */
+template <typename T>
+using LaneCounter = std::conditional_t<sizeof(T) == 1, std::uint8_t,
+                    std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                    std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+
+/** Blocks that can be counted before a lane counter of T's width could overflow. */
+template <typename T>
+constexpr std::size_t kFlushBlocks = sizeof(T) == 1 ? 255 : sizeof(T) == 2 ? 65535 : SIZE_MAX;
+
+/** @return Sum of the `count` lane counters stored at `lanes`. */
+template <typename T>
+std::size_t sumLanes(const void* lanes, std::size_t count) {
+    LaneCounter<T> buf[32];
+    std::memcpy(buf, lanes, count * sizeof(T));
+    std::size_t total = 0;
+    for (std::size_t j = 0; j < count; ++j) total += buf[j];
+    return total;
+}
+
+// ----- SSE2: 16-byte blocks, a lane of all ones per match -----
+
+template <typename T>
+inline __m128i eqVec128(__m128i v, const T& value) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(v), _mm_set1_ps(value)));
+    } else if constexpr (std::is_same_v<T, double>) {
+        return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(v), _mm_set1_pd(value)));
+    } else if constexpr (sizeof(T) == 1) {
+        return _mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(value)));
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm_cmpeq_epi16(v, _mm_set1_epi16(static_cast<short>(value)));
+    } else if constexpr (sizeof(T) == 4) {
+        return _mm_cmpeq_epi32(v, _mm_set1_epi32(static_cast<int>(value)));
+    } else {
+        /** No 64-bit compare in SSE2: both 32-bit halves must match. */
+        const __m128i c = _mm_cmpeq_epi32(v, _mm_set1_epi64x(static_cast<long long>(value)));
+        return _mm_and_si128(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+}
+
+/** @return Byte mask of the lanes equal to `value`. */
+template <typename T>
+inline unsigned eqMask128(__m128i v, const T& value) {
+    return static_cast<unsigned>(_mm_movemask_epi8(eqVec128(v, value)));
+}
+
+/** @return acc minus the compare result per lane (a match is -1, so the lane counts up). */
+template <typename T>
+inline __m128i countLanes128(__m128i acc, __m128i eq) {
+    if constexpr (sizeof(T) == 1) return _mm_sub_epi8(acc, eq);
+    else if constexpr (sizeof(T) == 2) return _mm_sub_epi16(acc, eq);
+    else if constexpr (sizeof(T) == 4) return _mm_sub_epi32(acc, eq);
+    else return _mm_sub_epi64(acc, eq);
+}
+
+template <typename T>
+std::size_t findSse2(const T* p, std::size_t n, const T& value) {
+    constexpr std::size_t W = 16 / sizeof(T);
+    std::size_t i = 0;
+    for (; i + W <= n; i += W) {
+        const unsigned m = eqMask128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), value);
+        if (m) return i + static_cast<std::size_t>(__builtin_ctz(m)) / sizeof(T);
+    }
+    return i + findScalar(p + i, n - i, value);
+}
+
+template <typename T>
+std::size_t countSse2(const T* p, std::size_t n, const T& value) {
+    constexpr std::size_t W = 16 / sizeof(T);
+    std::size_t total = 0, i = 0;
+    while (i + W <= n) {
+        __m128i acc = _mm_setzero_si128();
+        for (std::size_t b = 0; b < kFlushBlocks<T> && i + W <= n; ++b, i += W) {
+            acc = countLanes128<T>(acc, eqVec128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), value));
+        }
+        total += sumLanes<T>(&acc, W);
+    }
+    return total + countScalar(p + i, n - i, value);
+}
+
+/** SSE2 has no lane permute: match-free blocks move as one store, others lane by lane. */
+template <typename T>
+std::size_t removeSse2(T* p, std::size_t from, std::size_t n, const T& value) {
+    constexpr std::size_t W = 16 / sizeof(T);
+    std::size_t out = from, i = from;
+    for (; i + W <= n; i += W) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const unsigned m = eqMask128(v, value);
+        if (m == 0) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p + out), v);
+            out += W;
+        } else {
+            for (std::size_t j = 0; j < W; ++j) {
+                if (!(m & (1U << (j * sizeof(T))))) p[out++] = p[i + j];
+            }
+        }
+    }
+    const std::size_t kept = removeScalar(p, i, n, value) - i;
+    std::copy(p + i, p + i + kept, p + out);
+    return out + kept;
+}
+
+// ----- AVX2: 32-byte blocks, compress-store through the permute table -----
+
+template <typename T>
+EX4_TARGET_AVX2 inline __m256i eqVec256(__m256i v, const T& value) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(v), _mm256_set1_ps(value), _CMP_EQ_OQ));
+    } else if constexpr (std::is_same_v<T, double>) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(v), _mm256_set1_pd(value), _CMP_EQ_OQ));
+    } else if constexpr (sizeof(T) == 1) {
+        return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(static_cast<char>(value)));
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm256_cmpeq_epi16(v, _mm256_set1_epi16(static_cast<short>(value)));
+    } else if constexpr (sizeof(T) == 4) {
+        return _mm256_cmpeq_epi32(v, _mm256_set1_epi32(static_cast<int>(value)));
+    } else {
+        return _mm256_cmpeq_epi64(v, _mm256_set1_epi64x(static_cast<long long>(value)));
+    }
+}
+
+template <typename T>
+EX4_TARGET_AVX2 inline unsigned eqMask256(__m256i v, const T& value) {
+    return static_cast<unsigned>(_mm256_movemask_epi8(eqVec256(v, value)));
+}
+
+template <typename T>
+EX4_TARGET_AVX2 inline __m256i countLanes256(__m256i acc, __m256i eq) {
+    if constexpr (sizeof(T) == 1) return _mm256_sub_epi8(acc, eq);
+    else if constexpr (sizeof(T) == 2) return _mm256_sub_epi16(acc, eq);
+    else if constexpr (sizeof(T) == 4) return _mm256_sub_epi32(acc, eq);
+    else return _mm256_sub_epi64(acc, eq);
+}
+
+template <typename T>
+EX4_TARGET_AVX2 std::size_t findAvx2(const T* p, std::size_t n, const T& value) {
+    constexpr std::size_t W = 32 / sizeof(T);
+    std::size_t i = 0;
+    for (; i + W <= n; i += W) {
+        const unsigned m = eqMask256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), value);
+        if (m) return i + static_cast<std::size_t>(__builtin_ctz(m)) / sizeof(T);
+    }
+    return i + findScalar(p + i, n - i, value);
+}
+
+template <typename T>
+EX4_TARGET_AVX2 std::size_t countAvx2(const T* p, std::size_t n, const T& value) {
+    constexpr std::size_t W = 32 / sizeof(T);
+    std::size_t total = 0, i = 0;
+    while (i + W <= n) {
+        __m256i acc = _mm256_setzero_si256();
+        for (std::size_t b = 0; b < kFlushBlocks<T> && i + W <= n; ++b, i += W) {
+            acc = countLanes256<T>(acc, eqVec256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), value));
+        }
+        total += sumLanes<T>(&acc, W);
+    }
+    return total + countScalar(p + i, n - i, value);
+}
+
+/**
+ * Match-free blocks are stored whole. With 4- and 8-byte lanes a block holding matches is
+ * compressed with one permute and one unaligned store (garbage past the kept lanes is
+ * overwritten by the next store); 1- and 2-byte lanes have no cheap permute and are copied
+ * lane by lane.
+ * Writes never pass the block just read, so no unread element is clobbered.
+ */
+template <typename T>
+EX4_TARGET_AVX2 std::size_t removeAvx2(T* p, std::size_t from, std::size_t n, const T& value) {
+    constexpr std::size_t W = 32 / sizeof(T);
+    std::size_t out = from, i = from;
+    for (; i + W <= n; i += W) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i eq = eqVec256(v, value);
+        const unsigned m = static_cast<unsigned>(_mm256_movemask_epi8(eq));
+        if (m == 0) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + out), v);
+            out += W;
+        } else if constexpr (sizeof(T) >= 4) {
+            const unsigned hit = sizeof(T) == 4
+                ? static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)))
+                : static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(eq)));
+            const unsigned keep = ~hit & ((1U << W) - 1);
+            const unsigned keep32 = sizeof(T) == 8 ? widenMask4(keep) : keep;
+            const __m256i perm = _mm256_load_si256(reinterpret_cast<const __m256i*>(compressTable().lanes[keep32]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + out), _mm256_permutevar8x32_epi32(v, perm));
+            out += static_cast<std::size_t>(__builtin_popcount(keep));
+        } else {
+            for (std::size_t j = 0; j < W; ++j) {
+                if (!(m & (1U << (j * sizeof(T))))) p[out++] = p[i + j];
+            }
+        }
+    }
+    const std::size_t kept = removeScalar(p, i, n, value) - i;
+    std::copy(p + i, p + i + kept, p + out);
+    return out + kept;
+}
+
+#endif
+
+}
+
+/**
+ * @brief Index of the first element equal to `value`.
+ * @param level Instruction set to use (defaults to the best one available); ignored for
+ *              types that are not SimdScannable.
+ * @return Position of the first match, or n if there is none.
+ */
+template <typename T>
+std::size_t findEqual(const T* p, std::size_t n, const T& value, SimdLevel level = detectSimdLevel()) {
+#if defined(EX4_SIMD_X86)
+    if constexpr (SimdScannable<T>::enabled) {
+        if (level == SimdLevel::AVX2) return simd_detail::findAvx2(p, n, value);
+        if (level == SimdLevel::SSE2) return simd_detail::findSse2(p, n, value);
+    }
+#endif
+    (void)level;
+    return simd_detail::findScalar(p, n, value);
+}
+
+/** @return Number of elements equal to `value` among p[0, n). */
+template <typename T>
+std::size_t countEqual(const T* p, std::size_t n, const T& value, SimdLevel level = detectSimdLevel()) {
+#if defined(EX4_SIMD_X86)
+    if constexpr (SimdScannable<T>::enabled) {
+        if (level == SimdLevel::AVX2) return simd_detail::countAvx2(p, n, value);
+        if (level == SimdLevel::SSE2) return simd_detail::countSse2(p, n, value);
+    }
+#endif
+    (void)level;
+    return simd_detail::countScalar(p, n, value);
+}
+
+/**
+ * @brief Stable in-place removal of every element equal to `value` (like std::remove).
+ * @param from Elements before this index are known not to match and are left untouched.
+ * @return New logical size; p[result, n) holds unspecified values.
+ */
+template <typename T>
+std::size_t removeEqual(T* p, std::size_t n, const T& value, std::size_t from = 0,
+                        SimdLevel level = detectSimdLevel()) {
+#if defined(EX4_SIMD_X86)
+    if constexpr (SimdScannable<T>::enabled) {
+        if (level == SimdLevel::AVX2) return simd_detail::removeAvx2(p, from, n, value);
+        if (level == SimdLevel::SSE2) return simd_detail::removeSse2(p, from, n, value);
+    }
+#endif
+    (void)level;
+    return simd_detail::removeScalar(p, from, n, value);
+}
+
+}
@@ -1,7 +1,23 @@
 #pragma once
 #include <vector>      
+#include <memory>      
+#include <optional>    
+#include <utility>     
+#include <algorithm>   
 #include <stdexcept>   
 #include <cstddef>    
+#include <cstdint>
+#include "Instrumentation/Stats.hpp"
+#include "Instrumentation/Trace.hpp"
+#include "Index/SortedIndex.hpp"
+#include "Index/EytzingerIndex.hpp"
+#include "Index/DistinctRuns.hpp"
+#include "Kernels/SimdScan.hpp"
+#include "Kernels/SimdReduce.hpp"
+#include "Kernels/SimdHistogram.hpp"
+#include "Sketches/HeavyHitters.hpp"
+#include "Sketches/CountingBloomFilter.hpp"
+#include "Sketches/HyperLogLog.hpp"
 #include "Iterators/Order.hpp"          
 #include "Iterators/ReverseOrder.hpp"   
 #include "Iterators/AscendingOrder.hpp" 
@@ -18,54 +34,742 @@ namespace ex4 {
  * Notes:
  *  - Default template parameter is int, but any comparable T is supported by the sorted iterators.
  *  - Storage preserves insertion order in the `data` vector.
- *  - Iterators are snapshot-based (they receive a copied view when `begin_*` is called).
+ *  - Iterators are snapshot-based: they share an immutable view taken when `begin_*` is called.
+ *    Storage is copy-on-write, so building an insertion-order iterator copies nothing, and a
+ *    mutation only copies `data` while some iterator still references the old version.
+ *    Cost: the first addElement/removeElement after a snapshot is taken is O(n) (one copy of
+ *    `data`) for as long as that snapshot is alive; later mutations are O(1) amortized again
+ *    until the next snapshot. Iterators that copied on every begin_*() paid that O(n) each time.
+ *  - The sorted orders share one lazily built SortedIndex, cached until the next mutation.
+ *    With setStableOrder(true) equivalent elements keep their insertion order in it.
+ *  - With enableSearchIndex(), point and range queries (`contains`, `lower_bound`, `range`)
+ *    search an Eytzinger copy of the sorted view once it has at least kSearchIndexMinSize
+ *    elements, also cached per mutation (it costs a second copy of the elements).
+ *  - The container tracks how long the ascending prefix of `data` is. While every element was
+ *    appended in non-descending order the sorted orders are views over `data` itself (no
+ *    index, no sort); otherwise only the unsorted suffix is sorted and merged.
+ *  - Minimum and maximum (with their multiplicities) are maintained on `addElement`; removing
+ *    an extreme only marks them stale, and the next `min()`/`max()` recomputes them.
+ *  - Building with -DEX4_ENABLE_STATS enables per-operation counters and latency histograms
+ *    (see `stats()`); without it no instrumentation code or state is compiled in.
+ *  - Building with -DEX4_ENABLE_TRACE records tracing spans (see Instrumentation/Trace.hpp).
  */
 template <typename T = int>
 class MyContainer {
 private:
-    std::vector<T> data;  /** Underlying storage, preserves insertion order. */
+    std::shared_ptr<std::vector<T>> data;  /** Underlying storage, preserves insertion order (copy-on-write). */
+    mutable std::shared_ptr<const SortedIndex<T>> index;  /** Cached ascending index; reset on every mutation. */
+    mutable std::shared_ptr<const EytzingerIndex<T>> searchIndex;  /** Cached search layout; reset on every mutation. */
+    bool searchIndexEnabled = false;  /** Queries may build `searchIndex` (see enableSearchIndex). */
+    mutable std::shared_ptr<const DistinctRuns<T>> runs;  /** Cached distinct-value summary; reset on every mutation. */
+    std::size_t sortedPrefix = 0;  /** data[0, sortedPrefix) is non-descending. */
+    mutable std::optional<T> lo, hi;          /** Current minimum / maximum (meaningful when !extremesStale). */
+    mutable std::size_t loCount = 0;          /** Number of elements equivalent to `lo`. */
+    mutable std::size_t hiCount = 0;          /** Number of elements equivalent to `hi`. */
+    mutable bool extremesStale = false;       /** Set when an extreme was removed; cleared by refreshExtremes(). */
+    bool stableOrder = false;                 /** Sorted orders break ties by insertion index (see setStableOrder). */
+    std::shared_ptr<HeavyHitters<T>> heavy;  /** Optional heavy-hitter sketch (copy-on-write, like `data`). */
+    std::shared_ptr<CountingBloomFilter<T>> bloom;  /** Optional membership filter in front of removals (copy-on-write). */
+    double bloomRate = 0.01;                  /** Target false-positive rate `bloom` is rebuilt with. */
+    mutable std::shared_ptr<HyperLogLog<T>> hll;  /** Optional distinct-count sketch (copy-on-write). */
+    mutable bool hllStale = false;            /** Set by removals; approx_distinct() rebuilds `hll` first. */
+#ifdef EX4_ENABLE_STATS
+    mutable ContainerStats statistics;  /** Instrumentation sink (mutable: const traversals record into it). */
+#endif
+
+    /** The iterator factories record snapshot statistics through statsSink(). */
+    friend class Order<T>;
+    friend class ReverseOrder<T>;
+    friend class AscendingOrder<T>;
+    friend class DescendingOrder<T>;
+    friend class SideCrossOrder<T>;
+    friend class MiddleOutOrder<T>;
+
+#ifdef EX4_ENABLE_STATS
+    /** @return Writable stats sink used by the iterator factories. */
+    ContainerStats& statsSink() const { return statistics; }
+#endif
 
     /**
      * @brief Helper to print elements to an output stream as: "x y z \n".
      * @param os Output stream (defaults to std::cout).
      */
     void print(std::ostream& os = std::cout) const {
-        for (const auto& e : data) {
+        for (const auto& e : *data) {
             os << e << ' ';          /** Print each element followed by a space. */
         }
         os << std::endl;             /** End line after printing all elements. */
     }
 
+    /**
+     * @brief Prepare `data` for mutation: copy it if a live iterator still shares it,
+     *        and drop the cached sorted index and everything derived from it.
+     * Complexity: O(n) while a snapshot or iterator shares `data`, O(1) otherwise.
+     */
+    void detach() {
+        if (data.use_count() > 1) data = std::make_shared<std::vector<T>>(*data);
+        index.reset();
+        searchIndex.reset();
+        runs.reset();
+    }
+
+    /** @return The sketch `s` points to, copied first if another container still shares it. */
+    template <typename Sketch>
+    static Sketch& unshare(std::shared_ptr<Sketch>& s) {
+        if (s.use_count() > 1) s = std::make_shared<Sketch>(*s);
+        return *s;
+    }
+
+    /** @brief Build a Bloom filter sized for `expected` elements and fill it with the current data. */
+    void rebuildBloomFilter(std::size_t expected) {
+        auto filter = std::make_shared<CountingBloomFilter<T>>(expected, bloomRate);
+        for (const T& e : *data) filter->add(e);
+        bloom = std::move(filter);
+    }
+
+    /** @brief Replace the distinct-count sketch by one rebuilt from the current data (O(n)). */
+    void rebuildDistinctSketch() const {
+        auto sketch = std::make_shared<HyperLogLog<T>>(hll->bits());
+        for (const T& e : *data) sketch->add(e);
+        hll = std::move(sketch);
+        hllStale = false;
+    }
+
+    /** @brief Feed an added value to the enabled sketches (none for types without std::hash). */
+    void trackSketchesOnAdd(const T& value) {
+        if constexpr (IsHashable<T>::value) {
+            if (heavy) unshare(heavy).add(value);
+            if (bloom) unshare(bloom).add(value);
+            if (hll && !hllStale) unshare(hll).add(value);              /** A stale sketch is rebuilt anyway. */
+        }
+    }
+
+    /** @brief Rebuild the Bloom filter at twice the size once it holds more than double its capacity. */
+    void growBloomFilterIfFull() {
+        if constexpr (IsHashable<T>::value) {
+            if (bloom && data->size() > 2 * bloom->capacity()) rebuildBloomFilter(2 * data->size());  /** Keeps the rate; amortized O(1). */
+        }
+    }
+
+    /** @brief Tell the enabled sketches that all `removed` occurrences of `value` are gone. */
+    void trackSketchesOnRemove(const T& value, std::size_t removed) {
+        if constexpr (IsHashable<T>::value) {
+            if (heavy) unshare(heavy).erase(value, removed);
+            if (bloom) unshare(bloom).remove(value, removed);
+            if (hll) hllStale = true;                                   /** HyperLogLog cannot forget a value. */
+        }
+    }
+
+    /** @return false if the Bloom filter proves `value` absent (true when no filter is enabled). */
+    bool mayContain(const T& value) const {
+        if constexpr (IsHashable<T>::value) {
+            if (bloom) return bloom->mayContain(value);
+        }
+        (void)value;
+        return true;
+    }
+
+    /** @return The distinct-value summary of the sorted view (built on first use after a mutation). */
+    const std::shared_ptr<const DistinctRuns<T>>& distinctRuns() const {
+        if (!runs) runs = DistinctRuns<T>::build(sortedView());
+        return runs;
+    }
+
+    /** @return The ascending view (`data` itself while sorted), building the index if cold. */
+    const std::vector<T>& sortedView() const {
+        if (isSorted()) return *data;
+        if (!index && stableOrder) {
+            index = SortedIndex<T>::buildWithPositions(*data, sortedPrefix);
+        } else if (!index) {
+            std::optional<std::pair<T, T>> bounds;
+            if constexpr (CountingKey<T>::enabled) bounds.emplace(min(), max());  /** Tracked extremes pick counting sort. */
+            index = SortedIndex<T>::build(*data, sortedPrefix, bounds);
+        }
+        return index->keys;
+    }
+
+    /**
+     * @return The Eytzinger layout of the sorted view `v` (built on first use after a
+     *         mutation), or nullptr if it is disabled or `v` is small enough for plain binary search.
+     */
+    const EytzingerIndex<T>* searchLayout(const std::vector<T>& v) const {
+        if (!searchIndex) {
+            if (!searchIndexEnabled) return nullptr;
+            if (v.size() < kSearchIndexMinSize || v.size() > EytzingerIndex<T>::kMaxSize) return nullptr;
+            searchIndex = std::make_shared<const EytzingerIndex<T>>(v);
+        }
+        return searchIndex.get();
+    }
+
+    /**
+     * @brief Position in the sorted view `v` of the first element not less than `value`
+     *        (or, if `upper`, greater than `value`).
+     */
+    std::size_t sortedRank(const std::vector<T>& v, const T& value, bool upper) const {
+        if (const EytzingerIndex<T>* layout = searchLayout(v)) {
+            return upper ? layout->upperBound(value) : layout->lowerBound(value);
+        }
+        auto it = upper ? std::upper_bound(v.begin(), v.end(), value) : std::lower_bound(v.begin(), v.end(), value);
+        return static_cast<std::size_t>(it - v.begin());
+    }
+
+    /** @brief Fold a newly added value into the maintained extremes. O(1). */
+    void trackExtremesOnAdd(const T& value) {
+        if (extremesStale) return;                                  /** Next refresh will see it anyway. */
+        if (!lo || value < *lo) { lo = value; loCount = 1; }
+        else if (!(*lo < value)) ++loCount;
+        if (!hi || *hi < value) { hi = value; hiCount = 1; }
+        else if (!(value < *hi)) ++hiCount;
+    }
+
+    /**
+     * @brief Account for `removed` elements equal to `value`; stale if an extreme may have gone.
+     *
+     * The stored extreme stays valid only if equivalent elements remain and the stored
+     * representative itself was not removed.
+     */
+    void trackExtremesOnRemove(const T& value, std::size_t removed) {
+        if (extremesStale) return;
+        auto touches = [&](const std::optional<T>& e, std::size_t& cnt) {
+            if (!e || *e < value || value < *e) return false;       /** Not equivalent to this extreme. */
+            cnt -= removed;
+            return cnt == 0 || *e == value;
+        };
+        const bool loGone = touches(lo, loCount);
+        const bool hiGone = touches(hi, hiCount);
+        if (loGone || hiGone) extremesStale = true;
+    }
+
+    /**
+     * @brief Recompute min/max and their counts after an extreme was removed.
+     * Uses the sorted view when it is free (sorted data or warm index), else one linear scan.
+     */
+    void refreshExtremes() const {
+        if (!extremesStale) return;
+        lo.reset();
+        hi.reset();
+        loCount = hiCount = 0;
+        extremesStale = false;
+        if (data->empty()) return;
+        if (isIndexWarm()) {
+            auto v = sortedSnapshot();
+            lo = v->front();
+            hi = v->back();
+            loCount = static_cast<std::size_t>(std::upper_bound(v->begin(), v->end(), *lo) - v->begin());
+            hiCount = static_cast<std::size_t>(v->end() - std::lower_bound(v->begin(), v->end(), *hi));
+            return;
+        }
+        for (const T& e : *data) {
+            if (!lo || e < *lo) { lo = e; loCount = 1; }
+            else if (!(*lo < e)) ++loCount;
+            if (!hi || *hi < e) { hi = e; hiCount = 1; }
+            else if (!(e < *hi)) ++hiCount;
+        }
+    }
+
+    /**
+     * @brief Apply a batch. `added` and `removed` pair each value with its 1-based position in
+     *        the batch; elements stored before the batch count as position 0.
+     *
+     * An element of value v survives unless a removal of v comes after it. Survivors are
+     * copied into a new vector in one pass, so nothing changes until every removal is known
+     * to hit something, and readers of earlier snapshots keep the old vector. Storage is never
+     * modified in place, and the new vector is published with one atomic store, so snapshot()
+     * on another thread sees either the whole batch or none of it.
+     */
+    void applyBatch(const std::vector<std::pair<T, std::size_t>>& added, std::vector<std::pair<T, std::size_t>> removed) {
+        EX4_TRACE_SPAN("MyContainer::commit");
+        EX4_STATS(ScopedLatency timer(statistics.commitLatency);)
+        constexpr std::size_t kKept = SIZE_MAX;
+        std::stable_sort(removed.begin(), removed.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });  /** Equal values keep batch order. */
+        auto remover = [&](const T& value, std::size_t at) {                 /** Index of the removal deleting it, or kKept. */
+            if (removed.empty()) return kKept;
+            auto it = std::lower_bound(removed.begin(), removed.end(), value,
+                                       [](const auto& r, const T& v) { return r.first < v; });
+            for (; it != removed.end() && !(value < it->first); ++it) {
+                if (it->second > at && it->first == value) return static_cast<std::size_t>(it - removed.begin());
+            }
+            return kKept;
+        };
+
+        std::vector<std::size_t> hits(removed.size(), 0);                  /** Elements deleted by each removal... */
+        std::vector<std::size_t> stored(removed.size(), 0);                /** ...of which were stored before the batch. */
+        auto next = std::make_shared<std::vector<T>>();
+        std::size_t prefix = 0;
+        auto keep = [&](const T& value) {
+            if (prefix == next->size() && (next->empty() || !(value < next->back()))) ++prefix;
+            next->push_back(value);
+        };
+        next->reserve(data->size() + added.size());
+        for (const T& e : *data) {
+            const std::size_t r = remover(e, 0);
+            if (r == kKept) keep(e);
+            else { ++hits[r]; ++stored[r]; }
+        }
+        const std::size_t keptStored = next->size();
+        for (const auto& [value, at] : added) {
+            const std::size_t r = remover(value, at);
+            if (r == kKept) keep(value);
+            else ++hits[r];
+        }
+        if (std::find(hits.begin(), hits.end(), 0) != hits.end()) {
+            throw std::runtime_error("This element does not exist in the container");
+        }
+
+        const auto fresh = next->begin() + static_cast<std::ptrdiff_t>(keptStored);  /** Added elements that survived. */
+        std::shared_ptr<const SortedIndex<T>> patched;
+        if (index && !stableOrder && prefix != next->size()) {             /** Keep a warm index warm: one merge. */
+            patched = SortedIndex<T>::patch(*index, [&](const T& k) { return remover(k, 0) != kKept; }, fresh, next->end());
+        }
+        std::atomic_store(&data, std::move(next));                         /** Publish: pairs with snapshot(). */
+        sortedPrefix = prefix;
+        index = std::move(patched);
+        searchIndex.reset();
+        runs.reset();
+        for (std::size_t r = 0; r < removed.size(); ++r) {
+            if (stored[r] == 0) continue;                                     /** One entry per stored value. */
+            trackExtremesOnRemove(removed[r].first, stored[r]);
+            trackSketchesOnRemove(removed[r].first, stored[r]);
+        }
+        for (auto it = data->cbegin() + static_cast<std::ptrdiff_t>(keptStored); it != data->cend(); ++it) {
+            trackExtremesOnAdd(*it);
+            trackSketchesOnAdd(*it);
+        }
+        growBloomFilterIfFull();
+        EX4_STATS(statistics.adds += added.size();)                         /** Same counts as the equivalent calls. */
+        EX4_STATS(statistics.removes += removed.size();)
+        EX4_STATS(++statistics.commits;)
+    }
+
 public:
+    /** Smallest sorted view searched through the Eytzinger layout instead of binary search. */
+    static constexpr std::size_t kSearchIndexMinSize = 64;
+
     /** Default constructor: starts with an empty container. */
-    MyContainer() = default;
+    MyContainer() : data(std::make_shared<std::vector<T>>()) {}
+
+    /**
+     * Copies share storage until one side mutates (copy-on-write), so copying is O(1).
+     * No move operations are declared: a "move" is the same O(1) share and leaves the source usable.
+     */
+    MyContainer(const MyContainer&) = default;
+    MyContainer& operator=(const MyContainer&) = default;
 
     /**
      * @brief Append an element to the container (at the end).
      * @param value Value to insert.
      * Complexity: Amortized O(1).
      */
-    void addElement(const T& value) { data.push_back(value); }
+    void addElement(const T& value) {
+        EX4_STATS(ScopedLatency timer(statistics.addLatency);)
+        detach();
+        if (sortedPrefix == data->size() && (data->empty() || !(value < data->back()))) {
+            ++sortedPrefix;                                                    /** Still in ascending order. */
+        }
+        data->push_back(value);
+        trackExtremesOnAdd(value);
+        trackSketchesOnAdd(value);
+        growBloomFilterIfFull();
+        EX4_STATS(++statistics.adds;)
+    }
 
     /**
      * @brief Remove all occurrences of a given value.
      * @param value Value to remove (all duplicates removed).
      * @throws std::runtime_error if the value does not exist in the container.
-     * Complexity: O(n) (linear scan + erase).
+     * Complexity: as tryRemoveElement.
      */
     void removeElement(const T& value) {
-        auto before = data.size();                                             /** Remember size before removal. */
-        data.erase(std::remove(data.begin(), data.end(), value), data.end());  /** Erase all matches. */
-        if (data.size() == before) {                                           /** If size unchanged → nothing removed. */
+        if (tryRemoveElement(value) == 0) {
             throw std::runtime_error("This element does not exist in the container");
         }
     }
 
+    /**
+     * @brief Remove all occurrences of a given value, if there are any.
+     * @param value Value to remove (all duplicates removed).
+     * @return Number of elements removed (0 if the value was not present).
+     * Complexity: O(1) when the Bloom filter (see enableBloomFilter) proves the value absent;
+     *             otherwise O(n) (linear scan + erase), vectorized (SSE2/AVX2, chosen at run
+     *             time) for arithmetic T. A missing value returns before anything is copied.
+     */
+    std::size_t tryRemoveElement(const T& value) {
+        EX4_TRACE_SPAN("MyContainer::removeElement");
+        EX4_STATS(ScopedLatency timer(statistics.removeLatency);)
+        EX4_STATS(++statistics.removes;)
+        if (!mayContain(value)) return 0;                                      /** Definitely absent: no scan. */
+        const std::size_t before = data->size();
+        const std::size_t first = findEqual(data->data(), before, value);    /** Vectorized for arithmetic T. */
+        if (first == before) return 0;                                         /** Nothing to remove. */
+        detach();                                                              /** Copy only if shared. */
+        auto prefixEnd = data->begin() + static_cast<std::ptrdiff_t>(sortedPrefix);
+        auto range = std::equal_range(data->begin(), prefixEnd, value);        /** Matches inside the sorted prefix. */
+        sortedPrefix -= static_cast<std::size_t>(std::count(range.first, range.second, value));
+        const std::size_t kept = removeEqual(data->data(), before, value, first);  /** Compact from the first match. */
+        data->erase(data->begin() + static_cast<std::ptrdiff_t>(kept), data->end());
+        trackExtremesOnRemove(value, before - kept);
+        trackSketchesOnRemove(value, before - kept);
+        return before - kept;
+    }
+
+    /**
+     * @class Batch
+     * @brief Adds and removes recorded now and applied together by commit() (see batch()).
+     *
+     * Operations take effect in the order they were recorded, exactly as the same sequence of
+     * addElement/removeElement calls would, but commit() rewrites storage once: one compaction
+     * pass, one merge into a warm sorted index, and one publish of the new storage. Snapshots
+     * and iterators taken before the commit keep seeing the old contents in full.
+     * snapshot() may be called on other threads during a commit and sees the batch entirely
+     * or not at all; every other member still needs external synchronization.
+     * A batch refers to its container, which must outlive it; one that is destroyed or
+     * discarded without commit() changes nothing.
+     */
+    class Batch {
+        friend class MyContainer;
+
+        MyContainer* owner;
+        std::vector<std::pair<T, std::size_t>> added;    /** Values with their 1-based position in the batch. */
+        std::vector<std::pair<T, std::size_t>> removed;  /** Likewise. */
+        std::size_t ops = 0;
+
+        explicit Batch(MyContainer& c) : owner(&c) {}
+
+    public:
+        /** @brief Record addElement(value). O(1). */
+        Batch& add(const T& value) {
+            added.emplace_back(value, ++ops);
+            return *this;
+        }
+
+        /** @brief Record removeElement(value): all occurrences present at this point of the batch. O(1). */
+        Batch& remove(const T& value) {
+            removed.emplace_back(value, ++ops);
+            return *this;
+        }
+
+        /** @return Number of recorded operations. */
+        std::size_t size() const { return ops; }
+
+        /** @brief Drop the recorded operations. */
+        void discard() {
+            added.clear();
+            removed.clear();
+            ops = 0;
+        }
+
+        /**
+         * @brief Apply the recorded operations, then start over empty.
+         * @throws std::runtime_error if a removal finds nothing to remove; the container and
+         *         the batch are then left unchanged.
+         * Complexity: O(n log r + m) for n stored elements, m adds and r removals, plus
+         *             O(m log m + n) to merge the adds into a warm sorted index.
+         */
+        void commit() {
+            if (ops == 0) return;
+            owner->applyBatch(added, removed);
+            discard();
+        }
+    };
+
+    /**
+     * @brief Start a batch: `auto tx = c.batch(); tx.add(1); tx.remove(2); tx.commit();`
+     * @return An empty Batch bound to this container.
+     */
+    Batch batch() { return Batch(*this); }
+
     /**
      * @brief Current number of elements in the container.
      * @return size in elements.
      */
-    std::size_t size() const { return data.size(); }
+    std::size_t size() const { return data->size(); }
+
+    /**
+     * @brief Smallest / largest element.
+     * @return Reference to a representative element (valid until the next mutation).
+     * @throws std::runtime_error if the container is empty.
+     * Complexity: O(1); the first call after removing an extreme recomputes in O(n)
+     *             (O(log n) with a warm sorted index).
+     */
+    const T& min() const {
+        refreshExtremes();
+        if (!lo) throw std::runtime_error("The container is empty");
+        return *lo;
+    }
+    const T& max() const {
+        refreshExtremes();
+        if (!hi) throw std::runtime_error("The container is empty");
+        return *hi;
+    }
+
+    /**
+     * @brief Both extremes at once.
+     * @return {min(), max()}.
+     * @throws std::runtime_error if the container is empty.
+     */
+    std::pair<const T&, const T&> minmax() const { return {min(), max()}; }
+
+    /**
+     * @brief Sum of all elements (arithmetic T only).
+     * @param threads Worker threads for large containers (1 = caller only, 0 = all hardware threads).
+     * @return Exact 64-bit sum for integral T (wrapping like the 64-bit type); compensated
+     *         double sum for floating-point T. 0 for an empty container.
+     * Complexity: O(n), one AVX2 pass where available.
+     */
+    SumType<T> sum(std::size_t threads = 1) const { return sumOf(data->data(), data->size(), threads); }
+
+    /**
+     * @brief Arithmetic mean / population variance (arithmetic T only).
+     * @throws std::runtime_error if the container is empty.
+     * Unlike sum(), the mean of 64-bit integers does not wrap (see meanOf).
+     * Complexity: O(n); variance makes a second pass over the deviations from the mean.
+     */
+    double mean(std::size_t threads = 1) const {
+        if (data->empty()) throw std::runtime_error("The container is empty");
+        return meanOf(data->data(), data->size(), threads);
+    }
+    double variance(std::size_t threads = 1) const {
+        const double m = mean(threads);
+        return varianceOf(data->data(), data->size(), m, threads);
+    }
+
+    /**
+     * @brief Multiplicity of the minimum / maximum (elements equivalent to it).
+     * @return 0 for an empty container.
+     */
+    std::size_t minCount() const { refreshExtremes(); return loCount; }
+    std::size_t maxCount() const { refreshExtremes(); return hiCount; }
+
+    /**
+     * @brief Number of elements equal to `value`.
+     * Complexity: O(n), one vectorized pass (SSE2/AVX2, chosen at run time) for arithmetic T.
+     */
+    std::size_t count(const T& value) const { return countEqual(data->data(), data->size(), value); }
+
+    /**
+     * @brief Membership test.
+     * @return true if an element equivalent to `value` exists.
+     * Complexity: O(log n) once the sorted view is warm; the first query after a mutation
+     *             builds it (and, for large containers, the search layout) first.
+     */
+    bool contains(const T& value) const {
+        if (searchIndex) return searchIndex->contains(value);             /** Warm: no view lookup at all. */
+        const std::vector<T>& v = sortedView();
+        if (const EytzingerIndex<T>* layout = searchLayout(v)) return layout->contains(value);
+        return std::binary_search(v.begin(), v.end(), value);
+    }
+
+    /**
+     * @brief Ascending iterator at the first element not less than (lower_bound) or
+     *        greater than (upper_bound) `value`; compare with end_ascending_order().
+     * Complexity: O(log n) once the sorted view is warm.
+     */
+    AscendingOrder<T> lower_bound(const T& value) const {
+        auto v = sortedSnapshot();
+        const std::size_t r = sortedRank(*v, value, false);
+        return AscendingOrder<T>(std::move(v), r);
+    }
+    AscendingOrder<T> upper_bound(const T& value) const {
+        auto v = sortedSnapshot();
+        const std::size_t r = sortedRank(*v, value, true);
+        return AscendingOrder<T>(std::move(v), r);
+    }
+
+    /**
+     * @brief Elements in the closed interval [low, high], in ascending order.
+     * @return {begin, end} pair of AscendingOrder iterators (empty if high < low).
+     * Complexity: O(log n) once the sorted view is warm.
+     */
+    std::pair<AscendingOrder<T>, AscendingOrder<T>> range(const T& low, const T& high) const {
+        auto v = sortedSnapshot();
+        const std::size_t first = sortedRank(*v, low, false);
+        const std::size_t last = std::max(first, sortedRank(*v, high, true));
+        return {AscendingOrder<T>(v, first), AscendingOrder<T>(v, last)};
+    }
+
+    /** @return Number of elements in [low, high] (0 if high < low). O(log n) once warm. */
+    std::size_t count_range(const T& low, const T& high) const {
+        const std::vector<T>& v = sortedView();
+        const std::size_t first = sortedRank(v, low, false);
+        return std::max(first, sortedRank(v, high, true)) - first;
+    }
+
+    /**
+     * @brief Number of distinct values (equivalence classes of `<`).
+     * Complexity: O(1) once the distinct summary is cached; the first call after a mutation
+     *             builds it in one pass over the sorted view (sorting first if cold).
+     */
+    std::size_t distinct_count() const { return distinctRuns()->size(); }
+
+    /**
+     * @brief Frequency table: every distinct value with its multiplicity, ascending.
+     * Complexity: O(distinct) from the cached run-length summary (built in one pass over the
+     *             sorted view on first use after a mutation).
+     */
+    std::vector<std::pair<T, std::size_t>> value_counts() const {
+        const auto& r = distinctRuns();
+        std::vector<std::pair<T, std::size_t>> out;
+        out.reserve(r->size());
+        for (std::size_t i = 0; i < r->size(); ++i) out.emplace_back(r->values[i], r->count(i));
+        return out;
+    }
+
+    /**
+     * @brief Equal-width histogram (arithmetic T only).
+     * @param buckets Number of buckets (> 0).
+     * @param low, high Range covered; the last bucket includes `high`, values outside are not counted.
+     *                 Without them the range is [min(), max()] (all zeros for an empty container).
+     * @return Count per bucket.
+     * @throws std::invalid_argument if buckets == 0 or high < low.
+     * Complexity: O(n + buckets), one pass over the storage (AVX2 where available).
+     */
+    std::vector<std::size_t> histogram(std::size_t buckets, const T& low, const T& high) const {
+        if (buckets == 0) throw std::invalid_argument("Bucket count must be positive");
+        if (high < low) throw std::invalid_argument("Histogram range is empty");
+        return histogramOf(data->data(), data->size(), static_cast<double>(low), static_cast<double>(high), buckets);
+    }
+    std::vector<std::size_t> histogram(std::size_t buckets) const {
+        if (data->empty()) {
+            if (buckets == 0) throw std::invalid_argument("Bucket count must be positive");
+            return std::vector<std::size_t>(buckets, 0);
+        }
+        return histogram(buckets, min(), max());
+    }
+
+    /**
+     * @brief Start tracking approximate most-frequent values (types with std::hash only).
+     * @param k     Number of heavy hitters kept.
+     * @param width Count-Min counters per row; overestimates stay below about 2.7 * size() / width.
+     * @param depth Count-Min rows; each one lowers the chance of exceeding that bound.
+     * @throws std::invalid_argument if a size is 0.
+     *
+     * Current elements are counted once; afterwards every addElement/removeElement updates
+     * the sketch in O(depth + log k). Memory is O(width * depth + k).
+     */
+    void enableHeavyHitters(std::size_t k, std::size_t width = 2048, std::size_t depth = 4) {
+        static_assert(IsHashable<T>::value, "Heavy-hitter tracking requires std::hash<T>");
+        auto sketch = std::make_shared<HeavyHitters<T>>(k, width, depth);
+        for (const T& e : *data) sketch->add(e);
+        heavy = std::move(sketch);
+    }
+
+    /** @brief Stop tracking heavy hitters and free the sketch. */
+    void disableHeavyHitters() { heavy.reset(); }
+
+    /** @return true if heavy hitters are being tracked. */
+    bool isTrackingHeavyHitters() const { return static_cast<bool>(heavy); }
+
+    /**
+     * @brief Approximate most frequent values, most frequent first.
+     * @return Up to k {value, estimated count} pairs; estimates never undercount.
+     * @throws std::runtime_error if heavy-hitter tracking is not enabled.
+     * Complexity: O(k log k), independent of size().
+     */
+    std::vector<std::pair<T, std::size_t>> heavy_hitters() const {
+        if (!heavy) throw std::runtime_error("Heavy-hitter tracking is not enabled");
+        return heavy->top();
+    }
+
+    /**
+     * @brief Count-Min estimate of the occurrences of `value` (never less than count(value)).
+     * @throws std::runtime_error if heavy-hitter tracking is not enabled.
+     * Complexity: O(depth).
+     */
+    std::size_t estimated_count(const T& value) const {
+        if (!heavy) throw std::runtime_error("Heavy-hitter tracking is not enabled");
+        return static_cast<std::size_t>(heavy->estimate(value));
+    }
+
+    /**
+     * @brief Put a counting Bloom filter in front of removals (types with std::hash only), so
+     *        removing a value that is not present is rejected in O(1) instead of a full scan.
+     * @param expectedElements  Size the filter is planned for (defaults to the current size);
+     *                          it is rebuilt at twice the size whenever it holds more than double.
+     * @param falsePositiveRate Share of absent values that still fall through to the scan, in (0, 1).
+     * @throws std::invalid_argument if the rate is outside (0, 1).
+     *
+     * Current elements are added once; afterwards every addElement/removeElement updates the
+     * filter in O(hashes). Memory is about 1.44 * log2(1 / rate) bytes per expected element.
+     */
+    void enableBloomFilter(std::size_t expectedElements = 0, double falsePositiveRate = 0.01) {
+        static_assert(IsHashable<T>::value, "The Bloom filter requires std::hash<T>");
+        if (!(falsePositiveRate > 0.0 && falsePositiveRate < 1.0)) {
+            throw std::invalid_argument("False-positive rate must be in (0, 1)");
+        }
+        bloomRate = falsePositiveRate;
+        rebuildBloomFilter(std::max(expectedElements, data->size()));
+    }
+
+    /** @brief Stop filtering removals and free the filter. */
+    void disableBloomFilter() { bloom.reset(); }
+
+    /** @return true if removals are filtered by a Bloom filter. */
+    bool isBloomFilterEnabled() const { return static_cast<bool>(bloom); }
+
+    /**
+     * @brief Start estimating the number of distinct values (types with std::hash only).
+     * @param precision p in [4, 18]: 2^p bytes of registers, relative error about 1.04 / sqrt(2^p).
+     * @throws std::invalid_argument if `precision` is out of range.
+     *
+     * Current elements are added once; afterwards every addElement updates the sketch in O(1).
+     * Removals cannot be undone in a HyperLogLog, so they only mark it stale and the next
+     * approx_distinct() / distinctSketch() rebuilds it in O(n) (as min()/max() do).
+     */
+    void enableApproxDistinct(unsigned precision = 14) {
+        static_assert(IsHashable<T>::value, "Distinct-count estimation requires std::hash<T>");
+        hll = std::make_shared<HyperLogLog<T>>(precision);
+        rebuildDistinctSketch();
+    }
+
+    /** @brief Stop estimating distinct values and free the sketch. */
+    void disableApproxDistinct() {
+        hll.reset();
+        hllStale = false;
+    }
+
+    /** @return true if distinct values are being estimated. */
+    bool isTrackingApproxDistinct() const { return static_cast<bool>(hll); }
+
+    /**
+     * @brief The HyperLogLog sketch of the current elements, e.g. to merge shards:
+     *        `auto u = a.distinctSketch(); u.merge(b.distinctSketch()); u.estimate();`
+     * @throws std::runtime_error if distinct-count estimation is not enabled.
+     * Complexity: O(1), or O(n) for the first call after a removal.
+     */
+    const HyperLogLog<T>& distinctSketch() const {
+        if (!hll) throw std::runtime_error("Distinct-count estimation is not enabled");
+        if (hllStale) rebuildDistinctSketch();
+        return *hll;
+    }
+
+    /**
+     * @brief Approximate number of distinct values (see distinct_count() for the exact one).
+     * @throws std::runtime_error if distinct-count estimation is not enabled.
+     * Complexity: O(1), or O(n) for the first call after a removal.
+     */
+    double approx_distinct() const { return distinctSketch().estimate(); }
+
+    /**
+     * @brief Let point and range queries search an Eytzinger layout of the sorted view.
+     *
+     * The layout is built by the first query after a mutation once the container holds at
+     * least kSearchIndexMinSize elements. It holds a second copy of the elements plus a
+     * 32-bit rank per element, and in exchange keeps searches fast on large containers.
+     */
+    void enableSearchIndex() { searchIndexEnabled = true; }
+
+    /** @brief Search the sorted view directly and free the Eytzinger layout. */
+    void disableSearchIndex() {
+        searchIndexEnabled = false;
+        searchIndex.reset();
+    }
+
+    /** @return true if queries may use the Eytzinger search layout. */
+    bool isSearchIndexEnabled() const { return searchIndexEnabled; }
+
+    /** @return true if the Eytzinger search layout is cached for the current contents. */
+    bool isSearchIndexWarm() const { return static_cast<bool>(searchIndex); }
 
     /**
      * @brief Stream insertion operator (prints elements separated by spaces, ends with newline).
@@ -81,9 +785,112 @@ public:
      * @brief Read-only access to the underlying storage (used by iterator factories).
      * @return const reference to internal std::vector<T>.
      *
-     * Design note: Iterators copy from this vector to build their own traversal views.
      */
-    const std::vector<T>& getData() const { return data; }
+    const std::vector<T>& getData() const { return *data; }
+
+    /**
+     * @brief Shared, immutable insertion-order snapshot (used by iterator factories).
+     * @return The current storage; later mutations will not be visible through it.
+     * Complexity: O(1), no allocation.
+     * Safe to call from other threads while one thread commits batches (see Batch).
+     */
+    std::shared_ptr<const std::vector<T>> snapshot() const { return std::atomic_load(&data); }
+
+    /**
+     * @brief Shared, immutable ascending snapshot (used by the sorted iterator factories).
+     * @return `data` itself if it is already ascending, else the cached sorted keys
+     *         (built on first use after a mutation).
+     * Complexity: O(1) when sorted or warm; when cold O(m log m + n) for an unsorted suffix of m elements.
+     */
+    std::shared_ptr<const std::vector<T>> sortedSnapshot() const {
+        if (isSorted()) return data;                                          /** Monotone ingestion: data is the view. */
+        sortedView();                                                         /** Build the index if cold. */
+        return std::shared_ptr<const std::vector<T>>(index, &index->keys);  /** Aliasing: no allocation. */
+    }
+
+    /**
+     * @brief Sorted permutation of insertion positions ("argsort").
+     * @return Shared, immutable vector p with data[p[0]] <= data[p[1]] <= ...; equal elements
+     *         keep their insertion order. Valid (and unchanged) after later mutations.
+     * @throws std::length_error if the container has more than UINT32_MAX elements.
+     *
+     * The permutation is cached in the sorted index, so the ascending, descending and
+     * side-cross orders built afterwards share its keys instead of sorting again.
+     * Complexity: O(1) when cached; O(m log m + n) for an unsorted suffix of m elements.
+     */
+    std::shared_ptr<const std::vector<std::uint32_t>> argsort() const {
+        if (!index || index->positions.size() != data->size()) {
+            index = SortedIndex<T>::buildWithPositions(*data, sortedPrefix);
+        }
+        return std::shared_ptr<const std::vector<std::uint32_t>>(index, &index->positions);  /** Aliasing: no allocation. */
+    }
+
+    /**
+     * @brief Make the sorted orders deterministic: equivalent elements follow insertion order.
+     * @param on true for stable ascending order (descending is its exact reverse).
+     *
+     * A stable index is built like argsort (arithmetic keys packed with their insertion index
+     * into one radix-sortable integer), so the ties cost no extra sort pass and argsort()
+     * becomes free. Switching modes drops the cached index.
+     */
+    void setStableOrder(bool on) {
+        if (on == stableOrder) return;
+        stableOrder = on;
+        index.reset();
+        searchIndex.reset();
+        runs.reset();                                                   /** Representatives may change. */
+    }
+
+    /** @return true if the sorted orders break ties by insertion index. */
+    bool isStableOrder() const { return stableOrder; }
+
+    /**
+     * @brief Shared, immutable ascending snapshot of the distinct values (used by the unique orders).
+     * Complexity: O(1) when cached, else one pass over the sorted view.
+     */
+    std::shared_ptr<const std::vector<T>> distinctValues() const {
+        const auto& r = distinctRuns();
+        return std::shared_ptr<const std::vector<T>>(r, &r->values);    /** Aliasing: no allocation. */
+    }
+
+    /** @return true if the sorted index is cached (sorted traversals will not sort or allocate). */
+    bool isIndexWarm() const { return index || isSorted(); }
+
+    /** @return true if insertion order is already ascending (sorted orders are views over `data`). */
+    bool isSorted() const { return sortedPrefix == data->size(); }
+
+    /** @return Length of the non-descending prefix of insertion order. */
+    std::size_t sortedPrefixLength() const { return sortedPrefix; }
+
+    /**
+     * @brief Strategy used by the most recent build of the sorted index.
+     * @return AlreadySorted while insertion order is ascending; SortStrategy::None if no sorted
+     *         order was requested since the last mutation.
+     */
+    SortStrategy sortStrategy() const {
+        if (isSorted()) return SortStrategy::AlreadySorted;
+        return index ? index->strategy : SortStrategy::None;
+    }
+
+    /**
+     * @brief Instrumentation counters and latency histograms.
+     * @return The live stats when built with -DEX4_ENABLE_STATS, otherwise an always-empty object.
+     *
+     * Use `stats().json()` / `stats().toJson(os)` to dump them.
+     */
+    const ContainerStats& stats() const {
+#ifdef EX4_ENABLE_STATS
+        return statistics;
+#else
+        static const ContainerStats empty{};
+        return empty;
+#endif
+    }
+
+#ifdef EX4_ENABLE_STATS
+    /** @brief Clear all counters and histograms. */
+    void resetStats() { statistics = ContainerStats{}; }
+#endif
 
     // ===== Iterator entry points (each returns a snapshot-based iterator) =====
 
@@ -103,6 +910,22 @@ public:
     DescendingOrder<T> begin_descending_order() const { return DescendingOrder<T>::make(*this).first; }
     DescendingOrder<T> end_descending_order()   const { return DescendingOrder<T>::make(*this).second; }
 
+    /** @return begin/end for ascending traversal of distinct values (one representative per run). */
+    AscendingOrder<T> begin_unique_ascending_order() const { return AscendingOrder<T>(distinctValues(), 0); }
+    AscendingOrder<T> end_unique_ascending_order() const {
+        auto v = distinctValues();
+        const std::size_t n = v->size();
+        return AscendingOrder<T>(std::move(v), n);
+    }
+
+    /** @return begin/end for descending traversal of distinct values. */
+    DescendingOrder<T> begin_unique_descending_order() const { return DescendingOrder<T>(distinctValues(), 0); }
+    DescendingOrder<T> end_unique_descending_order() const {
+        auto v = distinctValues();
+        const std::size_t n = v->size();
+        return DescendingOrder<T>(std::move(v), n);
+    }
+
     /** @return begin/end for alternating low–high traversal. */
     SideCrossOrder<T> begin_side_cross_order() const { return SideCrossOrder<T>::make(*this).first; }
     SideCrossOrder<T> end_side_cross_order()   const { return SideCrossOrder<T>::make(*this).second; }
@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "SketchHash.hpp"
+
+namespace ex4 {
+
+/**
+ * @class CountingBloomFilter
+ * @brief Approximate membership with deletions: "definitely absent" or "maybe present".
+ *
+ * Overview:
+ *  - Each value increments `hashes` of the 8-bit counters (double hashing over one 64-bit
+ *    hash); it may be present only if all of them are non-zero. There are no false
+ *    negatives, and false positives stay near the configured rate up to `capacity()` elements.
+ *  - Removal decrements the same counters, so absent values become rejectable again.
+ *    A counter that reached 255 saturates and is never decremented (it can only cause a
+ *    false positive, never a false negative).
+ *  - Sized for n elements at false-positive rate p: m = -n ln p / ln^2 2 counters (rounded up
+ *    to a power of two) and round(m / n * ln 2) hashes.
+ */
+template <typename T>
+class CountingBloomFilter {
+    static constexpr std::uint8_t kSaturated = 255;
+
+    std::vector<std::uint8_t> counters;
+    std::size_t mask;              /** counters.size() - 1 (a power of two minus one). */
+    unsigned hashes;               /** Counters touched per value. */
+    std::size_t expected;          /** Element count the filter was sized for. */
+
+    template <typename F>
+    void forEachCounter(const T& value, F f) const {
+        const std::uint64_t h = sketchHash(value);
+        const std::uint64_t step = mix64(h) | 1;
+        for (unsigned i = 0; i < hashes; ++i) f(static_cast<std::size_t>((h + i * step) & mask));
+    }
+
+public:
+    /**
+     * @param expectedElements  Number of elements the filter should hold at the target rate.
+     * @param falsePositiveRate Target probability that an absent value reads as present, in (0, 1).
+     * @throws std::invalid_argument if the rate is outside (0, 1).
+     */
+    explicit CountingBloomFilter(std::size_t expectedElements, double falsePositiveRate = 0.01)
+        : expected(std::max<std::size_t>(expectedElements, 1)) {
+        if (!(falsePositiveRate > 0.0 && falsePositiveRate < 1.0)) {
+            throw std::invalid_argument("False-positive rate must be in (0, 1)");
+        }
+        const double ln2 = std::log(2.0);
+        const double bits = -static_cast<double>(expected) * std::log(falsePositiveRate) / (ln2 * ln2);
+        std::size_t m = 64;
+        while (static_cast<double>(m) < bits) m <<= 1;
+        counters.assign(m, 0);
+        mask = m - 1;
+        hashes = static_cast<unsigned>(std::max(1.0, std::round(bits / static_cast<double>(expected) * ln2)));
+    }
+
+    /** @brief Record `times` occurrences of `value`. O(hashes). */
+    void add(const T& value, std::uint64_t times = 1) {
+        forEachCounter(value, [&](std::size_t i) {
+            const std::uint64_t c = counters[i] + times;
+            counters[i] = static_cast<std::uint8_t>(std::min<std::uint64_t>(c, kSaturated));
+        });
+    }
+
+    /** @brief Forget `times` occurrences of `value` (which must have been added). O(hashes). */
+    void remove(const T& value, std::uint64_t times = 1) {
+        forEachCounter(value, [&](std::size_t i) {
+            if (counters[i] != kSaturated) counters[i] = static_cast<std::uint8_t>(counters[i] - std::min<std::uint64_t>(counters[i], times));
+        });
+    }
+
+    /** @return false if `value` is definitely absent; true if it may be present. O(hashes). */
+    bool mayContain(const T& value) const {
+        bool all = true;
+        forEachCounter(value, [&](std::size_t i) { all = all && counters[i] != 0; });
+        return all;
+    }
+
+    /** @return Element count the filter was sized for. */
+    std::size_t capacity() const { return expected; }
+
+    /** @return Number of counters. */
+    std::size_t counterCount() const { return counters.size(); }
+
+    /** @return Counters touched per value. */
+    unsigned hashCount() const { return hashes; }
+};
+
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+#include "SketchHash.hpp"
+
+namespace ex4 {
+
+/**
+ * @class HeavyHitters
+ * @brief Approximate most-frequent values: a Count-Min sketch plus a top-k candidate set.
+ *
+ * Overview:
+ *  - The Count-Min sketch keeps `depth` rows of `width` counters; a value adds to one counter
+ *    per row and its estimate is the smallest of them. Estimates never undercount, and with
+ *    width w they overcount by at most e/w of the total with probability 1 - e^-depth.
+ *  - The candidate set holds the k values with the largest estimates seen so far, in a
+ *    min-heap keyed by estimate (Space-Saving style): a new value replaces the smallest
+ *    candidate once its estimate is larger.
+ *  - Removals decrement the sketch (counters stay exact sums, so deletions are supported) and
+ *    refresh the candidate's estimate; a candidate whose estimate drops to 0 leaves the set.
+ *  - Memory is O(width * depth + k), independent of the number of distinct values.
+ */
+template <typename T>
+class HeavyHitters {
+    struct Candidate {
+        T value;
+        std::uint64_t estimate;
+    };
+
+    std::size_t k;
+    std::size_t width;                        /** Counters per row (a power of two). */
+    std::size_t depth;                        /** Rows (independent hash functions). */
+    std::vector<std::uint64_t> counters;      /** depth x width Count-Min counters. */
+    std::vector<Candidate> heap;              /** Min-heap of candidates by estimate. */
+    std::unordered_map<T, std::size_t> slot;  /** Candidate value -> position in `heap`. */
+    std::uint64_t total = 0;                  /** Number of elements currently counted. */
+
+    /** @return Index in `counters` of hash `h` in row `r` (double hashing over the two halves of h). */
+    std::size_t cell(std::uint64_t h, std::size_t r) const {
+        const std::uint64_t h2 = (h >> 32) | 1;
+        return r * width + static_cast<std::size_t>((h + r * h2) & (width - 1));
+    }
+
+    std::uint64_t estimateHashed(std::uint64_t h) const {
+        std::uint64_t e = UINT64_MAX;
+        for (std::size_t r = 0; r < depth; ++r) e = std::min(e, counters[cell(h, r)]);
+        return e;
+    }
+
+    void place(std::size_t i, Candidate c) {
+        slot[c.value] = i;
+        heap[i] = std::move(c);
+    }
+
+    void siftUp(std::size_t i) {
+        Candidate c = std::move(heap[i]);
+        while (i > 0) {
+            const std::size_t parent = (i - 1) / 2;
+            if (heap[parent].estimate <= c.estimate) break;
+            place(i, std::move(heap[parent]));
+            i = parent;
+        }
+        place(i, std::move(c));
+    }
+
+    void siftDown(std::size_t i) {
+        Candidate c = std::move(heap[i]);
+        for (;;) {
+            std::size_t child = 2 * i + 1;
+            if (child >= heap.size()) break;
+            if (child + 1 < heap.size() && heap[child + 1].estimate < heap[child].estimate) ++child;
+            if (c.estimate <= heap[child].estimate) break;
+            place(i, std::move(heap[child]));
+            i = child;
+        }
+        place(i, std::move(c));
+    }
+
+    /** @brief Remove the candidate at heap position `i`. */
+    void eraseAt(std::size_t i) {
+        slot.erase(heap[i].value);
+        if (i + 1 != heap.size()) {
+            place(i, std::move(heap.back()));
+            heap.pop_back();
+            siftDown(i);
+            siftUp(i);
+        } else {
+            heap.pop_back();
+        }
+    }
+
+public:
+    /**
+     * @param topK       Number of candidates kept (> 0).
+     * @param sketchWidth Counters per row (rounded up to a power of two).
+     * @param sketchDepth Number of rows (> 0).
+     * @throws std::invalid_argument if a size is 0.
+     */
+    HeavyHitters(std::size_t topK, std::size_t sketchWidth = 2048, std::size_t sketchDepth = 4)
+        : k(topK), width(1), depth(sketchDepth) {
+        if (topK == 0 || sketchWidth == 0 || sketchDepth == 0) {
+            throw std::invalid_argument("Heavy-hitter sizes must be positive");
+        }
+        while (width < sketchWidth) width <<= 1;
+        counters.assign(width * depth, 0);
+        heap.reserve(k);
+    }
+
+    /** @brief Count `times` more occurrences of `value`. O(depth + log k). */
+    void add(const T& value, std::uint64_t times = 1) {
+        const std::uint64_t h = sketchHash(value);
+        for (std::size_t r = 0; r < depth; ++r) counters[cell(h, r)] += times;
+        total += times;
+        const std::uint64_t e = estimateHashed(h);
+        auto it = slot.find(value);
+        if (it != slot.end()) {
+            heap[it->second].estimate = e;
+            siftDown(it->second);
+        } else if (heap.size() < k) {
+            heap.push_back(Candidate{value, e});
+            slot[value] = heap.size() - 1;
+            siftUp(heap.size() - 1);
+        } else if (heap.front().estimate < e) {
+            slot.erase(heap.front().value);
+            place(0, Candidate{value, e});
+            siftDown(0);
+        }
+    }
+
+    /**
+     * @brief Uncount `times` occurrences of `value` (which must have been added). O(depth + log k).
+     */
+    void remove(const T& value, std::uint64_t times = 1) {
+        const std::uint64_t h = sketchHash(value);
+        for (std::size_t r = 0; r < depth; ++r) {
+            std::uint64_t& c = counters[cell(h, r)];
+            c -= std::min(c, times);
+        }
+        total -= std::min(total, times);
+        auto it = slot.find(value);
+        if (it == slot.end()) return;
+        const std::size_t i = it->second;
+        heap[i].estimate = estimateHashed(h);
+        if (heap[i].estimate == 0) eraseAt(i);
+        else siftUp(i);
+    }
+
+    /**
+     * @brief Uncount the last `times` occurrences of `value`: its true count is now 0, so it
+     *        also leaves the candidate set. O(depth + log k).
+     */
+    void erase(const T& value, std::uint64_t times) {
+        remove(value, times);
+        auto it = slot.find(value);
+        if (it != slot.end()) eraseAt(it->second);
+    }
+
+    /** @return Estimated occurrences of `value` (never less than the true count). O(depth). */
+    std::uint64_t estimate(const T& value) const { return estimateHashed(sketchHash(value)); }
+
+    /**
+     * @brief Current candidates, most frequent first.
+     * @return Up to k {value, estimated count} pairs.
+     * Complexity: O(k log k).
+     */
+    std::vector<std::pair<T, std::size_t>> top() const {
+        std::vector<std::pair<T, std::size_t>> out;
+        out.reserve(heap.size());
+        for (const Candidate& c : heap) out.emplace_back(c.value, static_cast<std::size_t>(c.estimate));
+        std::stable_sort(out.begin(), out.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+        return out;
+    }
+
+    /** @return Number of elements currently counted. */
+    std::uint64_t count() const { return total; }
+
+    /** @return Candidate capacity. */
+    std::size_t capacity() const { return k; }
+};
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "SketchHash.hpp"
+
+namespace ex4 {
+
+/**
+ * @class HyperLogLog
+ * @brief Approximate number of distinct values in O(2^precision) bytes.
+ *
+ * Overview:
+ *  - The top `precision` bits of a value's 64-bit hash pick one of m = 2^precision registers;
+ *    the register keeps the largest "position of the first 1-bit" seen in the remaining bits.
+ *    The harmonic mean of 2^register estimates the distinct count with relative standard
+ *    error about 1.04 / sqrt(m) (0.8% at the default precision 14). Small counts use linear
+ *    counting over the empty registers; a 64-bit hash needs no large-range correction.
+ *  - A histogram of register values is kept up to date, so `estimate()` costs O(64) no
+ *    matter how many registers there are.
+ *  - Registers only grow, so values cannot be removed; `merge` (register-wise max) gives the
+ *    sketch of the union, which lets shards be combined. Equal values hash alike across
+ *    sketches, so merged sketches never double-count.
+ */
+template <typename T>
+class HyperLogLog {
+    static constexpr unsigned kMaxRank = 64;          /** Bound on register values (at most 65 - precision). */
+
+    unsigned precision;
+    std::vector<std::uint8_t> registers;
+    std::array<std::uint32_t, kMaxRank + 1> rankCounts{};  /** rankCounts[r] = registers holding r. */
+
+    /** @return Number of leading zero bits of a non-zero `x`. */
+    static unsigned leadingZeros(std::uint64_t x) {
+#if defined(__GNUC__)
+        return static_cast<unsigned>(__builtin_clzll(x));
+#else
+        unsigned n = 0;
+        for (; !(x >> 63); x <<= 1) ++n;
+        return n;
+#endif
+    }
+
+    void raise(std::size_t i, std::uint8_t rank) {
+        if (rank <= registers[i]) return;
+        --rankCounts[registers[i]];
+        ++rankCounts[rank];
+        registers[i] = rank;
+    }
+
+public:
+    static constexpr unsigned kMinPrecision = 4;
+    static constexpr unsigned kMaxPrecision = 18;
+
+    /**
+     * @param bits Precision p in [4, 18]: 2^p registers of one byte each.
+     * @throws std::invalid_argument if `bits` is out of range.
+     */
+    explicit HyperLogLog(unsigned bits = 14) : precision(bits) {
+        if (bits < kMinPrecision || bits > kMaxPrecision) {
+            throw std::invalid_argument("HyperLogLog precision must be in [4, 18]");
+        }
+        registers.assign(std::size_t{1} << bits, 0);
+        rankCounts[0] = static_cast<std::uint32_t>(registers.size());
+    }
+
+    /** @brief Observe `value`. O(1). */
+    void add(const T& value) {
+        const std::uint64_t h = sketchHash(value);
+        const std::uint64_t rest = h << precision;
+        const unsigned rank = rest == 0 ? 64 - precision + 1 : leadingZeros(rest) + 1;
+        raise(static_cast<std::size_t>(h >> (64 - precision)), static_cast<std::uint8_t>(rank));
+    }
+
+    /**
+     * @brief Fold `other` into this sketch: afterwards it estimates the union of both inputs.
+     * @throws std::invalid_argument if the precisions differ.
+     * Complexity: O(m).
+     */
+    void merge(const HyperLogLog& other) {
+        if (other.precision != precision) {
+            throw std::invalid_argument("Cannot merge HyperLogLog sketches of different precision");
+        }
+        for (std::size_t i = 0; i < registers.size(); ++i) raise(i, other.registers[i]);
+    }
+
+    /** @return Estimated number of distinct values observed. O(1). */
+    double estimate() const {
+        const double m = static_cast<double>(registers.size());
+        double harmonic = 0.0;
+        for (unsigned r = 0; r <= kMaxRank; ++r) {
+            if (rankCounts[r] != 0) harmonic += std::ldexp(static_cast<double>(rankCounts[r]), -static_cast<int>(r));
+        }
+        const double alpha = precision == 4 ? 0.673 : precision == 5 ? 0.697 : precision == 6 ? 0.709
+                                                                            : 0.7213 / (1.0 + 1.079 / m);
+        const double raw = alpha * m * m / harmonic;
+        if (raw <= 2.5 * m && rankCounts[0] != 0) {
+            return m * std::log(m / static_cast<double>(rankCounts[0]));   /** Linear counting. */
+        }
+        return raw;
+    }
+
+    /** @return Precision p (the sketch has 2^p registers). */
+    unsigned bits() const { return precision; }
+
+    /** @return Relative standard error of `estimate()`, 1.04 / sqrt(2^p). */
+    double standardError() const { return 1.04 / std::sqrt(static_cast<double>(registers.size())); }
+};
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+
+namespace ex4 {
+
+/**
+ * @brief True if std::hash<T> is usable: the sketches hash elements and are only
+ *        available (and only maintained by MyContainer) for such T.
+ */
+template <typename T, typename = void>
+struct IsHashable : std::false_type {};
+
+template <typename T>
+struct IsHashable<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T&>()))>> : std::true_type {};
+
+/** @brief SplitMix64 finalizer: spreads std::hash output (often the identity) over 64 bits. */
+inline std::uint64_t mix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/** @return Well-mixed 64-bit hash of `value`, varied by `seed`. */
+template <typename T>
+std::uint64_t sketchHash(const T& value, std::uint64_t seed = 0) {
+    return mix64(static_cast<std::uint64_t>(std::hash<T>{}(value)) ^ mix64(seed));
+}
+
+}
@@ -1,14 +1,92 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#ifndef EX4_ENABLE_STATS
+#define EX4_ENABLE_STATS   // Tests run with instrumentation compiled in (Main.cpp covers the disabled build).
+#endif
 #include "doctest.h"
 #include "MyContainer.hpp" 
+#include "Backends/SharedMemoryContainer.hpp"
+#include "Backends/WindowContainer.hpp"
+#include "Backends/ConcurrentSkipListContainer.hpp"
+#include "Backends/BPlusTreeContainer.hpp"
+#include "Backends/RoaringContainer.hpp"
+#include "Instrumentation/Trace.hpp"
 #include <sstream>          
 #include <vector>            
 #include <string>          
 #include <algorithm>      
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <climits>
+#include <limits>
+#include <cmath>
+#include <numeric>
+#include <set>
+#include <thread>
 
 using namespace ex4;        
 
 
+// Allocation-tracking harness: every global operator new in this binary bumps a counter,
+// so tests can assert how many heap allocations an operation performs. All overloads are
+// replaced (plain, array, nothrow, aligned), so none escapes the count and every delete
+// pairs with the replaced allocator.
+
+static std::atomic<std::size_t> g_allocations{0};
+
+static void* countedAlloc(std::size_t n, std::size_t align) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (n == 0) n = 1;
+    if (align <= alignof(std::max_align_t)) return std::malloc(n);
+    return std::aligned_alloc(align, (n + align - 1) / align * align);  // Size must be a multiple of the alignment.
+}
+static void* countedAllocOrThrow(std::size_t n, std::size_t align) {
+    if (void* p = countedAlloc(n, align)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t n) { return countedAllocOrThrow(n, 0); }
+void* operator new[](std::size_t n) { return countedAllocOrThrow(n, 0); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n, 0); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n, 0); }
+void* operator new(std::size_t n, std::align_val_t a) { return countedAllocOrThrow(n, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t n, std::align_val_t a) { return countedAllocOrThrow(n, static_cast<std::size_t>(a)); }
+void* operator new(std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept {
+    return countedAlloc(n, static_cast<std::size_t>(a));
+}
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept {
+    return countedAlloc(n, static_cast<std::size_t>(a));
+}
+// GCC pairs the inlined malloc/free across the replacement and warns; the pairing is intentional.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+
+// Counts allocations made between construction and the call to count().
+struct AllocationCounter {
+    std::size_t start = g_allocations.load(std::memory_order_relaxed);
+    std::size_t count() const { return g_allocations.load(std::memory_order_relaxed) - start; }
+};
+
+
 // Helper custom type for simple non-primitive coverage (kept minimal).
 // Note: We avoid “Student”; here we use a small “Book” struct.
 
@@ -434,3 +512,1388 @@ TEST_CASE("Iterator operators: prefix/postfix ++ and end dereference throws (Ord
     CHECK(it == c.end_order());
     CHECK_THROWS_AS(*it, std::out_of_range);
 }
+
+// SharedMemoryContainer backend (POSIX shared memory, one writer / many readers)
+
+TEST_CASE("SharedMemoryContainer - reader sees published insertion and ascending orders") {
+    const std::string name = "/ex4_test_" + std::to_string(::getpid());
+    MyContainer<int> c;
+    for (int x : baseA) c.addElement(x);
+
+    auto writer = SharedMemoryContainer<int>::create(name, 16);
+    writer.publish(c);
+
+    auto reader = SharedMemoryContainer<int>::open(name);
+    auto g = reader.generation();
+    CHECK(reader.size() == baseA.size());
+    CHECK(std::vector<int>(reader.begin_order(), reader.end_order()) == baseA);
+    CHECK(std::vector<int>(reader.begin_ascending_order(), reader.end_ascending_order())
+          == std::vector<int>{1, 2, 6, 7, 15});
+    CHECK(std::vector<int>(reader.begin_descending_order(), reader.end_descending_order())
+          == std::vector<int>{15, 7, 6, 2, 1});
+    CHECK(reader.validate(g));
+
+    // A new publish invalidates the reader's generation and is visible in place.
+    c.addElement(-4);
+    writer.publish(c);
+    CHECK_FALSE(reader.validate(g));
+    CHECK(*reader.begin_ascending_order() == -4);
+
+    CHECK_THROWS_AS(reader.publish(c), std::runtime_error);
+
+    // A writer that died mid-publish leaves the generation odd: readers must not spin forever.
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    REQUIRE(fd >= 0);
+    void* raw = ::mmap(nullptr, 64, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    REQUIRE(raw != MAP_FAILED);
+    auto* gen = reinterpret_cast<std::atomic<std::uint64_t>*>(static_cast<char*>(raw) + 3 * sizeof(std::uint64_t));
+    gen->fetch_add(1);                                // Fourth header word: the seqlock counter
+    std::uint64_t odd = 0;
+    CHECK_FALSE(reader.tryGeneration(odd));
+    CHECK(odd % 2 == 1);
+    CHECK_THROWS_AS(reader.generation(std::chrono::milliseconds(20)), std::runtime_error);
+    gen->fetch_add(1);
+    CHECK(reader.tryGeneration(g));
+    ::munmap(raw, 64);
+    SharedMemoryContainer<int>::unlink(name);
+}
+
+TEST_CASE("SharedMemoryContainer - child process traverses without copying") {
+    const std::string name = "/ex4_test_fork_" + std::to_string(::getpid());
+    MyContainer<int> c;
+    for (int x : baseB) c.addElement(x);
+    auto writer = SharedMemoryContainer<int>::create(name, baseB.size());
+    writer.publish(c);
+
+    pid_t pid = ::fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0) {
+        // Child: attach read-only and verify the ascending region (-20 5 10 190 190).
+        auto reader = SharedMemoryContainer<int>::open(name);
+        std::vector<int> expected = {-20, 5, 10, 190, 190};
+        bool ok = std::equal(expected.begin(), expected.end(),
+                             reader.begin_ascending_order(), reader.end_ascending_order());
+        ::_exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    CHECK(WIFEXITED(status));
+    CHECK(WEXITSTATUS(status) == 0);
+
+    MyContainer<int> big;
+    for (int i = 0; i < 10; ++i) big.addElement(i);
+    CHECK_THROWS_AS(writer.publish(big), std::runtime_error);
+    SharedMemoryContainer<int>::unlink(name);
+}
+
+// Instrumentation (EX4_ENABLE_STATS)
+
+TEST_CASE("stats() - counts adds, removes, snapshots, sorts and copied bytes per order") {
+    MyContainer<int> c;
+    for (int x : baseA) c.addElement(x);
+    c.removeElement(15);
+    CHECK_THROWS_AS(c.removeElement(999), std::runtime_error);
+
+    for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) {}
+    (void)c.begin_order();
+
+    const ContainerStats& s = c.stats();
+    CHECK(s.adds == baseA.size());
+    CHECK(s.removes == 2);
+    CHECK(s.addLatency.count() == baseA.size());
+    CHECK(s.removeLatency.count() == 2);
+
+    const OrderStats& asc = s.order(OrderKind::Ascending);
+    CHECK(asc.snapshots >= 2);                        // begin + at least one end call
+    CHECK(asc.sorts == 1);                            // Later calls reuse the warm index
+    CHECK(asc.bytesCopied == 4 * sizeof(int));        // One copy into the sorted index
+    CHECK(s.order(OrderKind::Insertion).bytesCopied == 0);
+    CHECK(asc.makeLatency.count() == asc.snapshots);
+    CHECK(s.order(OrderKind::Insertion).snapshots == 1);
+    CHECK(s.order(OrderKind::Descending).snapshots == 0);
+
+    std::string json = s.json();
+    CHECK(json.find("\"adds\":5") != std::string::npos);
+    CHECK(json.find("\"side_cross\":{\"snapshots\":0") != std::string::npos);
+
+    c.resetStats();
+    CHECK(c.stats().adds == 0);
+}
+
+TEST_CASE("LatencyHistogram - percentiles are within one sub-bucket") {
+    LatencyHistogram h;
+    for (std::uint64_t v = 1; v <= 1000; ++v) h.record(v);
+    CHECK(h.count() == 1000);
+    CHECK(h.min() == 1);
+    CHECK(h.max() == 1000);
+    std::uint64_t p50 = h.percentile(50);
+    CHECK(p50 <= 500);
+    CHECK(p50 >= 500 - 500 / 8);
+    CHECK(h.percentile(100) <= 1000);
+}
+
+// Allocation budgets (global operator new hook above)
+
+TEST_CASE("Allocations - the hook counts nothrow and aligned operator new too") {
+    struct alignas(128) Wide { char bytes[128]; };
+    AllocationCounter a;
+    void* p = ::operator new(16, std::nothrow);                       // std::get_temporary_buffer path
+    Wide* w = new Wide();
+    Wide* ws = new (std::nothrow) Wide[3];
+    CHECK(a.count() == 3);
+    CHECK(reinterpret_cast<std::uintptr_t>(w) % 128 == 0);
+    CHECK(reinterpret_cast<std::uintptr_t>(ws) % 128 == 0);
+    ::operator delete(p, std::nothrow);
+    delete w;
+    delete[] ws;
+}
+
+TEST_CASE("Allocations - insertion, reverse and middle-out traversals allocate 0 times") {
+    MyContainer<int> c;
+    for (int x : baseA) c.addElement(x);
+
+    AllocationCounter a;
+    long sum = 0;
+    for (auto it = c.begin_order(); it != c.end_order(); ++it) sum += *it;
+    for (auto it = c.begin_reverse_order(); it != c.end_reverse_order(); ++it) sum += *it;
+    for (auto it = c.begin_middle_out_order(); it != c.end_middle_out_order(); ++it) sum += *it;
+    std::size_t allocations = a.count();
+    CHECK(allocations == 0);
+    CHECK(sum == 3 * 31);
+}
+
+TEST_CASE("Allocations - sorted traversals with a warm index allocate 0 times") {
+    MyContainer<int> c;
+    for (int x : baseB) c.addElement(x);
+
+    CHECK_FALSE(c.isIndexWarm());
+    AllocationCounter cold;
+    (void)c.begin_ascending_order();                  // Builds the index: shared block + key buffer
+    std::size_t coldAllocations = cold.count();
+    CHECK(coldAllocations <= 2);
+    CHECK(c.isIndexWarm());
+
+    AllocationCounter warm;
+    long sum = 0;
+    for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) sum += *it;
+    for (auto it = c.begin_descending_order(); it != c.end_descending_order(); ++it) sum += *it;
+    for (auto it = c.begin_side_cross_order(); it != c.end_side_cross_order(); ++it) sum += *it;
+    std::size_t warmAllocations = warm.count();
+    CHECK(warmAllocations == 0);
+    CHECK(sum == 3 * 375);
+
+    c.addElement(0);                                  // Any mutation makes the index cold again
+    CHECK_FALSE(c.isIndexWarm());
+}
+
+TEST_CASE("Allocations - addElement/removeElement copy storage only while an iterator shares it") {
+    MyContainer<int> c;
+    for (int x : baseA) c.addElement(x);
+    c.removeElement(15);                              // Ensure spare capacity for the next push
+
+    AllocationCounter unshared;
+    c.addElement(3);
+    std::size_t unsharedAllocations = unshared.count();
+    CHECK(unsharedAllocations == 0);
+
+    auto it = c.begin_order();                        // Snapshot taken here
+    c.removeElement(7);                               // Copy-on-write detaches the container
+    CHECK(*it == 7);                                  // The iterator still sees its snapshot
+    CHECK(c.getData()[0] == 6);
+    CHECK(c.size() == 4);
+
+    CHECK_THROWS_AS(c.removeElement(999), std::runtime_error);
+    CHECK(c.size() == 4);
+}
+
+// Tracing (Chrome trace format)
+
+TEST_CASE("TraceSpan - records completed spans and writes Chrome trace JSON") {
+    TraceRecorder& r = TraceRecorder::instance();
+    r.clear();
+    {
+        TraceSpan outer("outer");
+        TraceSpan inner("inner");
+    }
+    auto events = r.snapshot();
+    REQUIRE(events.size() == 2);
+    CHECK(std::string(events[0].name) == "inner");    // Inner span closes first
+    CHECK(std::string(events[1].name) == "outer");
+    CHECK(events[1].startNs <= events[0].startNs);
+    CHECK(events[1].durNs >= events[0].durNs);
+
+    std::ostringstream os;
+    r.writeChromeTrace(os);
+    CHECK(os.str().rfind("{\"traceEvents\":[{\"name\":\"inner\",\"cat\":\"ex4\",\"ph\":\"X\"", 0) == 0);
+    r.clear();
+
+    r.setCapacity(3);                                 // Bounded: the newest spans overwrite the oldest
+    const char* names[] = {"s0", "s1", "s2", "s3", "s4"};
+    for (const char* n : names) TraceSpan span(n);
+    events = r.snapshot();
+    REQUIRE(events.size() == 3);
+    CHECK(std::string(events[0].name) == "s2");
+    CHECK(std::string(events[2].name) == "s4");
+    CHECK(r.dropped() == 2);
+    std::ostringstream bounded;
+    r.writeChromeTrace(bounded);
+    CHECK(bounded.str().find("{\"name\":\"s2\"") < bounded.str().find("{\"name\":\"s4\""));
+    CHECK(bounded.str().find("\"dropped_events\":2") != std::string::npos);
+    r.setCapacity(1);
+    CHECK(r.snapshot().size() == 1);
+    CHECK(r.dropped() == 4);
+    r.setCapacity(TraceRecorder::kDefaultCapacity);
+    r.clear();
+}
+
+// Adaptive sorted-index builder
+
+TEST_CASE("sortStrategy - picks a strategy from the presortedness of the data") {
+    auto strategyFor = [](const std::vector<int>& values) {
+        MyContainer<int> c;
+        for (int x : values) c.addElement(x);
+        if (!c.isSorted()) CHECK(c.sortStrategy() == SortStrategy::None);  // Nothing built yet
+        std::vector<int> expected = values;
+        std::sort(expected.begin(), expected.end());
+        std::vector<int> got;
+        for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) got.push_back(*it);
+        CHECK(got == expected);
+        return c.sortStrategy();
+    };
+
+    std::vector<int> ascending(1000), descending(1000), tenRuns(1000), random(1000);
+    std::mt19937 rng(7);
+    for (int i = 0; i < 1000; ++i) {
+        ascending[i] = i / 3;                                   // Non-descending with duplicates
+        descending[i] = 1000 - i;
+        tenRuns[i] = (i % 100) * 10 + i / 100;                  // Ten interleaving sorted blocks
+        random[i] = static_cast<int>(rng() % 2001) - 1000;
+    }
+    CHECK(strategyFor(ascending) == SortStrategy::AlreadySorted);
+    CHECK(strategyFor(descending) == SortStrategy::Reversed);
+    CHECK(strategyFor(tenRuns) == SortStrategy::RunMerge);
+    CHECK(strategyFor(random) == SortStrategy::Radix);
+    CHECK(strategyFor(baseA) == SortStrategy::Insertion);
+    CHECK(std::string(sortStrategyName(SortStrategy::RunMerge)) == "run_merge");
+}
+
+TEST_CASE("adaptiveSort - radix and comparison paths agree with std::sort") {
+    std::mt19937 rng(11);
+    std::vector<double> d(3000);
+    for (auto& x : d) x = static_cast<double>(static_cast<int>(rng() % 20001) - 10000) / 7.0;
+    std::vector<double> expectedD = d;
+    std::sort(expectedD.begin(), expectedD.end());
+    CHECK(adaptiveSort(d) == SortStrategy::Radix);
+    CHECK(d == expectedD);
+
+    std::vector<std::string> s(500);
+    for (auto& x : s) x = std::to_string(rng() % 1000);
+    std::vector<std::string> expectedS = s;
+    std::sort(expectedS.begin(), expectedS.end());
+    CHECK(adaptiveSort(s) == SortStrategy::Comparison);
+    CHECK(s == expectedS);
+
+    std::vector<std::int8_t> small(400);
+    for (auto& x : small) x = static_cast<std::int8_t>(rng());
+    std::vector<std::int8_t> expectedSmall = small;
+    std::sort(expectedSmall.begin(), expectedSmall.end());
+    adaptiveSort(small);
+    CHECK(small == expectedSmall);
+}
+
+TEST_CASE("adaptiveSort - counting sort for small-range integers and enums") {
+    enum class Color : std::uint8_t { Red, Green, Blue, Black };
+    std::mt19937 rng(5);
+
+    MyContainer<std::uint8_t> bytes;
+    MyContainer<std::int16_t> shorts;
+    MyContainer<Color> colors;
+    for (int i = 0; i < 2000; ++i) {
+        bytes.addElement(static_cast<std::uint8_t>(rng()));
+        shorts.addElement(static_cast<std::int16_t>(static_cast<int>(rng() % 1500) - 700));
+        colors.addElement(static_cast<Color>(rng() % 4));
+    }
+
+    auto checkSorted = [](const auto& c) {
+        auto expected = c.getData();
+        std::sort(expected.begin(), expected.end());
+        decltype(expected) asc, desc;
+        for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) asc.push_back(*it);
+        for (auto it = c.begin_descending_order(); it != c.end_descending_order(); ++it) desc.push_back(*it);
+        CHECK(asc == expected);
+        CHECK(desc == decltype(expected)(expected.rbegin(), expected.rend()));
+        return c.sortStrategy();
+    };
+    CHECK(checkSorted(bytes) == SortStrategy::Counting);
+    CHECK(checkSorted(shorts) == SortStrategy::Counting);         // Range 1500 < n = 2000
+    CHECK(checkSorted(colors) == SortStrategy::Counting);
+    CHECK(std::string(sortStrategyName(SortStrategy::Counting)) == "counting");
+
+    shorts.addElement(30000);                                      // Range now exceeds n: radix instead
+    CHECK(checkSorted(shorts) == SortStrategy::Radix);
+
+    std::vector<long long> wide = {LLONG_MAX, LLONG_MIN, 0};      // Range computed without overflow
+    for (int i = 0; i < 100; ++i) wide.push_back(i % 2 ? LLONG_MIN : LLONG_MAX);
+    std::vector<long long> expectedWide = wide;
+    std::sort(expectedWide.begin(), expectedWide.end());
+    CHECK(adaptiveSort(wide) != SortStrategy::Counting);
+    CHECK(wide == expectedWide);
+}
+
+// Append-sorted fast path (sorted prefix tracking)
+
+TEST_CASE("Sorted prefix - monotone ingestion makes sorted orders views over insertion order") {
+    MyContainer<int> c;
+    for (int x : {1, 2, 2, 5, 9}) c.addElement(x);
+    CHECK(c.isSorted());
+    CHECK(c.sortedPrefixLength() == 5);
+
+    AllocationCounter a;
+    long sum = 0;
+    for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) sum += *it;
+    for (auto it = c.begin_descending_order(); it != c.end_descending_order(); ++it) sum += *it;
+    std::size_t allocations = a.count();
+    CHECK(allocations == 0);                          // No index was built, nothing was sorted
+    CHECK(sum == 2 * 19);
+    CHECK(*c.begin_descending_order() == 9);
+
+    c.removeElement(2);                               // Removing keeps the remainder sorted
+    CHECK(c.isSorted());
+    CHECK(c.sortedPrefixLength() == 3);
+
+    c.addElement(0);                                  // Out of order: prefix stops growing
+    c.addElement(7);
+    CHECK_FALSE(c.isSorted());
+    CHECK(c.sortedPrefixLength() == 3);
+    c.removeElement(5);                               // Prefix shrinks by the removed matches
+    CHECK(c.sortedPrefixLength() == 2);
+}
+
+TEST_CASE("Sorted prefix - only the unsorted suffix is sorted and merged") {
+    MyContainer<int> c;
+    for (int i = 0; i < 900; ++i) c.addElement(i * 2);
+    for (int i = 0; i < 100; ++i) c.addElement(1797 - i * 18);   // Late, out-of-order arrivals
+    CHECK(c.sortedPrefixLength() == 900);
+
+    std::vector<int> expected = c.getData();
+    std::sort(expected.begin(), expected.end());
+    std::vector<int> got;
+    for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) got.push_back(*it);
+    CHECK(got == expected);
+    CHECK(c.sortStrategy() == SortStrategy::PrefixMerge);
+}
+
+// WindowContainer (ring buffer + indexable skip list)
+
+TEST_CASE("WindowContainer - keeps the last N values and traverses them in every order") {
+    WindowContainer<int> w(4);
+    for (int x : {5, 1, 9, 3, 7, 2}) w.addElement(x);   // 5 and 1 are evicted
+    CHECK(w.size() == 4);
+    CHECK(w.capacity() == 4);
+
+    auto collect = [](auto it, auto end) {
+        std::vector<int> out;
+        for (; it != end; ++it) out.push_back(*it);
+        return out;
+    };
+    CHECK(collect(w.begin_order(), w.end_order()) == std::vector<int>{9, 3, 7, 2});
+    CHECK(collect(w.begin_reverse_order(), w.end_reverse_order()) == std::vector<int>{2, 7, 3, 9});
+    CHECK(collect(w.begin_ascending_order(), w.end_ascending_order()) == std::vector<int>{2, 3, 7, 9});
+    CHECK(collect(w.begin_descending_order(), w.end_descending_order()) == std::vector<int>{9, 7, 3, 2});
+    CHECK(w.min() == 2);
+    CHECK(w.max() == 9);
+    CHECK(w.median() == 3);
+    CHECK(w.at_rank(2) == 7);
+
+    w.removeElement(3);
+    CHECK(collect(w.begin_order(), w.end_order()) == std::vector<int>{9, 7, 2});
+    CHECK_THROWS_AS(w.removeElement(3), std::runtime_error);
+    CHECK_THROWS_AS(*w.end_order(), std::out_of_range);
+    CHECK_THROWS_AS(WindowContainer<int>(0), std::invalid_argument);
+
+    std::ostringstream oss;
+    oss << w;
+    CHECK(oss.str() == "9 7 2 \n");
+}
+
+TEST_CASE("WindowContainer - sliding median matches a sorted copy of the window") {
+    WindowContainer<int> w(50);
+    std::vector<int> all;
+    std::mt19937 rng(3);
+    for (int i = 0; i < 2000; ++i) {
+        int v = static_cast<int>(rng() % 40);            // Plenty of duplicates
+        w.addElement(v);
+        all.push_back(v);
+        std::vector<int> window(all.end() - static_cast<long>(w.size()), all.end());
+        std::sort(window.begin(), window.end());
+        REQUIRE(w.median() == window[(window.size() - 1) / 2]);
+        REQUIRE(w.min() == window.front());
+        REQUIRE(w.max() == window.back());
+    }
+    std::vector<int> asc;
+    for (auto it = w.begin_ascending_order(); it != w.end_ascending_order(); ++it) asc.push_back(*it);
+    std::vector<int> expected(all.end() - 50, all.end());
+    std::sort(expected.begin(), expected.end());
+    CHECK(asc == expected);
+}
+
+// Maintained extremes: min(), max(), minmax()
+
+TEST_CASE("min/max - maintained on add, lazily recomputed after removing an extreme") {
+    MyContainer<int> c;
+    CHECK_THROWS_AS(c.min(), std::runtime_error);
+    CHECK_THROWS_AS(c.max(), std::runtime_error);
+    CHECK(c.minCount() == 0);
+
+    for (int x : baseB) c.addElement(x);              // {10, -20, 190, 190, 5}
+    CHECK(c.min() == -20);
+    CHECK(c.max() == 190);
+    CHECK(c.maxCount() == 2);
+    auto mm = c.minmax();
+    CHECK(mm.first == -20);
+    CHECK(mm.second == 190);
+
+    c.removeElement(190);                             // Removes both maxima → recompute
+    CHECK(c.max() == 10);
+    CHECK(c.maxCount() == 1);
+    c.removeElement(5);                               // Not an extreme: nothing recomputed
+    CHECK(c.min() == -20);
+
+    c.addElement(-20);
+    CHECK(c.minCount() == 2);
+    c.removeElement(-20);
+    c.removeElement(10);
+    CHECK_THROWS_AS(c.min(), std::runtime_error);
+}
+
+TEST_CASE("min/max - equivalent but unequal elements keep a valid representative") {
+    MyContainer<Book> c;
+    c.addElement({"A", 100});
+    c.addElement({"B", 100});                         // Equivalent to A (same pages), not equal
+    c.addElement({"C", 300});
+    CHECK(c.min() == Book{"A", 100});
+    CHECK(c.minCount() == 2);
+
+    c.removeElement({"A", 100});                      // The stored representative is gone
+    CHECK(c.min() == Book{"B", 100});
+    CHECK(c.minCount() == 1);
+    CHECK(c.max() == Book{"C", 300});
+}
+
+// ConcurrentSkipListContainer (lock-free inserts, weakly consistent traversals)
+
+TEST_CASE("ConcurrentSkipListContainer - sorted traversals, logical removal and compaction") {
+    ConcurrentSkipListContainer<int> c;
+    for (int x : baseB) c.addElement(x);              // {10, -20, 190, 190, 5}
+    CHECK(c.size() == 5);
+
+    auto collect = [](auto it, auto end) {
+        std::vector<int> out;
+        for (; it != end; ++it) out.push_back(*it);
+        return out;
+    };
+    CHECK(collect(c.begin_ascending_order(), c.end_ascending_order()) == std::vector<int>{-20, 5, 10, 190, 190});
+    CHECK(collect(c.begin_descending_order(), c.end_descending_order()) == std::vector<int>{190, 190, 10, 5, -20});
+
+    c.removeElement(190);
+    c.removeElement(-20);
+    CHECK_THROWS_AS(c.removeElement(190), std::runtime_error);
+    CHECK(c.size() == 2);
+    CHECK_FALSE(c.contains(190));
+    CHECK(c.contains(5));
+    CHECK(collect(c.begin_ascending_order(), c.end_ascending_order()) == std::vector<int>{5, 10});
+    CHECK(collect(c.begin_descending_order(), c.end_descending_order()) == std::vector<int>{10, 5});
+
+    c.compact();
+    CHECK(collect(c.begin_ascending_order(), c.end_ascending_order()) == std::vector<int>{5, 10});
+    CHECK_THROWS_AS(*c.end_ascending_order(), std::out_of_range);
+}
+
+TEST_CASE("ConcurrentSkipListContainer - concurrent inserts while readers traverse") {
+    ConcurrentSkipListContainer<int> c;
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 5000;
+    std::atomic<bool> done{false};
+    std::atomic<bool> readerSawDisorder{false};
+
+    std::thread reader([&] {
+        while (!done.load()) {
+            bool first = true;
+            int prev = 0;
+            for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) {
+                if (!first && *it < prev) readerSawDisorder = true;
+                prev = *it;
+                first = false;
+            }
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+        writers.emplace_back([&c, t] {
+            std::mt19937 rng(static_cast<unsigned>(t));
+            for (int i = 0; i < kPerThread; ++i) c.addElement(static_cast<int>(rng() % 1000));
+        });
+    }
+    for (auto& w : writers) w.join();
+    done = true;
+    reader.join();
+
+    CHECK_FALSE(readerSawDisorder.load());
+    CHECK(c.size() == static_cast<std::size_t>(kThreads * kPerThread));
+    std::vector<int> asc;
+    for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) asc.push_back(*it);
+    CHECK(asc.size() == static_cast<std::size_t>(kThreads * kPerThread));
+    CHECK(std::is_sorted(asc.begin(), asc.end()));
+}
+
+// BPlusTreeContainer (page-sized nodes, leaf-chain traversal)
+
+TEST_CASE("BPlusTreeContainer - default nodes fill one 4 KiB page") {
+    CHECK(sizeof(BPlusTreeContainer<int>::Leaf) == 4096);
+    CHECK(BPlusTreeContainer<int>::kLeafCapacity > 1000);
+    CHECK(BPlusTreeContainer<std::string>::kLeafCapacity >= 4);
+}
+
+TEST_CASE("BPlusTreeContainer - matches a sorted reference under random adds and removes") {
+    BPlusTreeContainer<int, 64> c;                    // Tiny nodes: deep tree, many splits and merges.
+    std::vector<int> ref;
+    std::mt19937 rng(7);
+    auto checkSame = [&] {
+        std::vector<int> asc, desc;
+        for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) asc.push_back(*it);
+        for (auto it = c.begin_descending_order(); it != c.end_descending_order(); ++it) desc.push_back(*it);
+        std::vector<int> sorted = ref;
+        std::sort(sorted.begin(), sorted.end());
+        CHECK(asc == sorted);
+        CHECK(desc == std::vector<int>(sorted.rbegin(), sorted.rend()));
+        CHECK(c.size() == ref.size());
+    };
+
+    for (int i = 0; i < 3000; ++i) {
+        int v = static_cast<int>(rng() % 200);
+        c.addElement(v);
+        ref.push_back(v);
+    }
+    CHECK(c.height() > 3);
+    checkSame();
+
+    for (int round = 0; round < 150; ++round) {
+        int v = static_cast<int>(rng() % 220);
+        bool present = std::find(ref.begin(), ref.end(), v) != ref.end();
+        CHECK(c.contains(v) == present);
+        if (present) {
+            c.removeElement(v);                       // ~15 copies per value: runs span several leaves.
+            ref.erase(std::remove(ref.begin(), ref.end(), v), ref.end());
+        } else {
+            CHECK_THROWS_AS(c.removeElement(v), std::runtime_error);
+        }
+        if (round % 25 == 0) checkSame();
+    }
+    checkSame();
+    if (!ref.empty()) {
+        CHECK(c.min() == *std::min_element(ref.begin(), ref.end()));
+        CHECK(c.max() == *std::max_element(ref.begin(), ref.end()));
+    }
+
+    for (int v = 0; v < 220; ++v) {
+        if (c.contains(v)) c.removeElement(v);
+    }
+    ref.clear();
+    CHECK(c.size() == 0);
+    CHECK(c.height() == 1);
+    CHECK(c.begin_ascending_order() == c.end_ascending_order());
+    CHECK_THROWS_AS(c.min(), std::runtime_error);
+}
+
+TEST_CASE("BPlusTreeContainer - copies, strings and printing") {
+    BPlusTreeContainer<std::string, 256> words;
+    for (const char* w : {"pear", "apple", "fig", "apple", "kiwi"}) words.addElement(w);
+    BPlusTreeContainer<std::string, 256> copy = words;
+    words.removeElement("apple");
+
+    std::ostringstream out;
+    out << words << copy;
+    CHECK(out.str() == "fig kiwi pear \napple apple fig kiwi pear \n");
+    CHECK(*copy.begin_descending_order() == "pear");
+    CHECK_THROWS_AS(*words.end_ascending_order(), std::out_of_range);
+}
+
+TEST_CASE("BPlusTreeContainer - equivalent but unequal keys (Book sorts by pages)") {
+    BPlusTreeContainer<Book, 256> shelf;                              // A few books per leaf
+    shelf.addElement(Book{"a", 100});
+    shelf.addElement(Book{"b", 100});
+    CHECK(shelf.contains(Book{"b", 100}));
+    CHECK_FALSE(shelf.contains(Book{"c", 100}));
+    shelf.removeElement(Book{"b", 100});
+    CHECK(shelf.size() == 1);
+    CHECK((*shelf.begin_ascending_order()).title == "a");
+    CHECK_THROWS_AS(shelf.removeElement(Book{"b", 100}), std::runtime_error);
+
+    for (int i = 0; i < 40; ++i) shelf.addElement(Book{std::string(1, static_cast<char>('c' + i % 3)), 100});
+    shelf.addElement(Book{"z", 50});
+    shelf.addElement(Book{"z", 150});
+    CHECK(shelf.contains(Book{"e", 100}));                            // Equivalent run spans leaves
+    shelf.removeElement(Book{"e", 100});
+    CHECK(shelf.size() == 1 + 40 - 13 + 2);
+    CHECK_FALSE(shelf.contains(Book{"e", 100}));
+    CHECK(shelf.contains(Book{"d", 100}));
+    for (auto it = shelf.begin_ascending_order(); it != shelf.end_ascending_order(); ++it) CHECK((*it).title != "e");
+}
+
+// Point and range queries (EytzingerIndex)
+
+TEST_CASE("EytzingerIndex - lowerBound/upperBound/contains match std:: on every size") {
+    for (std::size_t n = 0; n <= 70; ++n) {
+        std::vector<int> sorted;
+        for (std::size_t i = 0; i < n; ++i) sorted.push_back(static_cast<int>(i / 3) * 2);  // Duplicates and gaps.
+        EytzingerIndex<int> layout(sorted);
+        CHECK(layout.size() == n);
+        for (int q = -1; q <= static_cast<int>(n) + 1; ++q) {
+            CHECK(layout.lowerBound(q) == static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), q) - sorted.begin()));
+            CHECK(layout.upperBound(q) == static_cast<std::size_t>(std::upper_bound(sorted.begin(), sorted.end(), q) - sorted.begin()));
+            CHECK(layout.contains(q) == std::binary_search(sorted.begin(), sorted.end(), q));
+        }
+    }
+}
+
+TEST_CASE("MyContainer - contains, lower_bound and range queries") {
+    SUBCASE("small container: binary search over the sorted view") {
+        MyContainer<int> c;
+        for (int x : baseB) c.addElement(x);          // {10, -20, 190, 190, 5}
+        CHECK(c.contains(190));
+        CHECK_FALSE(c.contains(11));
+        CHECK_FALSE(c.isSearchIndexWarm());
+        CHECK(*c.lower_bound(6) == 10);
+        CHECK(*c.upper_bound(10) == 190);
+        CHECK(c.lower_bound(191) == c.end_ascending_order());
+        CHECK(c.count_range(5, 190) == 4);
+        CHECK(c.count_range(190, 5) == 0);
+
+        std::vector<int> got;
+        auto r = c.range(-20, 10);
+        for (auto it = r.first; it != r.second; ++it) got.push_back(*it);
+        CHECK(got == std::vector<int>{-20, 5, 10});
+    }
+
+    SUBCASE("large container: Eytzinger layout, cached until the next mutation") {
+        MyContainer<int> c;
+        c.enableSearchIndex();
+        std::vector<int> ref;
+        std::mt19937 rng(3);
+        for (std::size_t i = 0; i < 4 * MyContainer<int>::kSearchIndexMinSize; ++i) {
+            int v = static_cast<int>(rng() % 1000);
+            c.addElement(v);
+            ref.push_back(v);
+        }
+        std::sort(ref.begin(), ref.end());
+        for (int q = -5; q < 1005; q += 7) {
+            CHECK(c.contains(q) == std::binary_search(ref.begin(), ref.end(), q));
+            auto lb = std::lower_bound(ref.begin(), ref.end(), q);
+            if (lb == ref.end()) CHECK(c.lower_bound(q) == c.end_ascending_order());
+            else CHECK(*c.lower_bound(q) == *lb);
+            CHECK(c.count_range(q, q + 50) == static_cast<std::size_t>(
+                std::upper_bound(ref.begin(), ref.end(), q + 50) - lb));
+        }
+        CHECK(c.isSearchIndexWarm());
+
+        auto it = c.lower_bound(500);                 // Snapshot survives the mutation below.
+        c.addElement(500);
+        CHECK_FALSE(c.isSearchIndexWarm());
+        CHECK(*it == *std::lower_bound(ref.begin(), ref.end(), 500));
+        CHECK(c.contains(500));
+        CHECK(c.isSearchIndexWarm());
+
+        c.disableSearchIndex();                       // Off: binary search, no second copy.
+        CHECK_FALSE(c.isSearchIndexWarm());
+        CHECK(c.contains(500));
+        CHECK(c.count_range(0, 999) == ref.size() + 1);
+        CHECK_FALSE(c.isSearchIndexWarm());
+    }
+}
+
+// RoaringContainer (dense uint32_t sets)
+
+namespace {
+/** Random id set mixing a dense chunk (bitmap form), a sparse chunk (array form) and outliers. */
+std::set<std::uint32_t> makeIdSet(unsigned seed) {
+    std::mt19937 rng(seed);
+    std::set<std::uint32_t> ids;
+    for (int i = 0; i < 20000; ++i) ids.insert(rng() % 40000);                 // Dense: chunk 0.
+    for (int i = 0; i < 300; ++i) ids.insert(0x30000u + rng() % 65536);        // Sparse: chunk 3.
+    ids.insert(0xFFFFFFFFu);
+    return ids;
+}
+
+template <typename It>
+std::vector<std::uint32_t> drain(It it, It end) {
+    std::vector<std::uint32_t> out;
+    for (; it != end; ++it) out.push_back(*it);
+    return out;
+}
+}
+
+TEST_CASE("RoaringContainer - set semantics and traversals") {
+    MyContainer<std::uint32_t> source;
+    for (std::uint32_t x : {5u, 70000u, 5u, 3u, 70000u, 1u << 31}) source.addElement(x);
+    RoaringContainer r(source);
+    CHECK(r.size() == 4);                              // Duplicates collapse.
+    CHECK(drain(r.begin_ascending_order(), r.end_ascending_order()) == std::vector<std::uint32_t>{3, 5, 70000, 1u << 31});
+    CHECK(drain(r.begin_descending_order(), r.end_descending_order()) == std::vector<std::uint32_t>{1u << 31, 70000, 5, 3});
+    CHECK(drain(r.begin_side_cross_order(), r.end_side_cross_order()) == std::vector<std::uint32_t>{3, 1u << 31, 5, 70000});
+    CHECK(r.min() == 3);
+    CHECK(r.max() == (1u << 31));
+
+    r.removeElement(70000);
+    CHECK_FALSE(r.contains(70000));
+    CHECK_THROWS_AS(r.removeElement(70000), std::runtime_error);
+    CHECK_THROWS_AS(*r.end_ascending_order(), std::out_of_range);
+
+    RoaringContainer empty;
+    CHECK(empty.begin_side_cross_order() == empty.end_side_cross_order());
+    CHECK_THROWS_AS(empty.min(), std::runtime_error);
+
+    MyContainer<int> negative;                         // Would wrap to 4294967295.
+    negative.addElement(7);
+    negative.addElement(-1);
+    CHECK_THROWS_AS(RoaringContainer{negative}, std::out_of_range);
+    MyContainer<std::int64_t> wide;
+    wide.addElement(std::int64_t(1) << 32);            // Would wrap to 0.
+    CHECK_THROWS_AS(RoaringContainer{wide}, std::out_of_range);
+    wide.removeElement(std::int64_t(1) << 32);
+    wide.addElement(UINT32_MAX);
+    CHECK(RoaringContainer(wide).contains(UINT32_MAX));
+}
+
+TEST_CASE("RoaringContainer - dense chunks use bitmaps and match a reference set") {
+    const std::set<std::uint32_t> ref = makeIdSet(1);
+    RoaringContainer r;
+    for (std::uint32_t x : ref) r.addElement(x);
+    CHECK(r.size() == ref.size());
+    CHECK(r.bitmapChunks() == 1);
+    CHECK(drain(r.begin_ascending_order(), r.end_ascending_order()) == std::vector<std::uint32_t>(ref.begin(), ref.end()));
+    CHECK(drain(r.begin_descending_order(), r.end_descending_order()) == std::vector<std::uint32_t>(ref.rbegin(), ref.rend()));
+
+    std::vector<std::uint32_t> sorted(ref.begin(), ref.end()), cross;
+    for (std::size_t i = 0, j = sorted.size(); i < j;) {
+        cross.push_back(sorted[i++]);
+        if (i < j) cross.push_back(sorted[--j]);
+    }
+    CHECK(drain(r.begin_side_cross_order(), r.end_side_cross_order()) == cross);
+
+    std::size_t removed = 0;
+    for (std::uint32_t x : ref) {
+        if (x < 40000 && removed < 17000) {
+            r.removeElement(x);
+            ++removed;
+        }
+    }
+    CHECK(r.bitmapChunks() == 0);                      // Fell below half the array limit.
+    CHECK(r.size() == ref.size() - removed);
+    CHECK(r.contains(0xFFFFFFFFu));
+}
+
+TEST_CASE("RoaringContainer - union, intersection and difference") {
+    const std::set<std::uint32_t> a = makeIdSet(2), b = makeIdSet(3);
+    RoaringContainer ra, rb;
+    for (std::uint32_t x : a) ra.addElement(x);
+    for (std::uint32_t x : b) rb.addElement(x);
+
+    std::vector<std::uint32_t> expect;
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect));
+    RoaringContainer u = ra | rb;
+    CHECK(u.size() == expect.size());
+    CHECK(drain(u.begin_ascending_order(), u.end_ascending_order()) == expect);
+
+    expect.clear();
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect));
+    RoaringContainer in = ra & rb;
+    CHECK(drain(in.begin_ascending_order(), in.end_ascending_order()) == expect);
+
+    expect.clear();
+    std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect));
+    RoaringContainer d = ra - rb;
+    CHECK(d.size() == expect.size());
+    CHECK(drain(d.begin_ascending_order(), d.end_ascending_order()) == expect);
+    CHECK((ra - ra).size() == 0);
+}
+
+// Batch pull (next_batch / copy_to)
+
+TEST_CASE("Iterators - next_batch and copy_to match element-wise traversal in every order") {
+    MyContainer<int> c;
+    std::mt19937 rng(9);
+    for (int i = 0; i < 53; ++i) c.addElement(static_cast<int>(rng() % 40) - 20);
+
+    auto check = [](auto begin, auto end) {
+        std::vector<int> expected;
+        for (auto it = begin; it != end; ++it) expected.push_back(*it);
+
+        int peek[4];
+        CHECK(begin.copy_to(peek, 4) == 4);           // Does not advance
+        CHECK(*begin == peek[0]);
+
+        int buf[7];
+        std::vector<int> got;
+        got.reserve(expected.size());
+        AllocationCounter a;
+        std::size_t calls = 0;
+        for (std::size_t k; (k = begin.next_batch(buf, 7)) > 0; ++calls) got.insert(got.end(), buf, buf + k);
+        std::size_t allocations = a.count();
+        CHECK(allocations == 0);
+        CHECK(got == expected);
+        CHECK(calls == (expected.size() + 6) / 7);
+        CHECK(begin == end);
+        CHECK(begin.next_batch(buf, 7) == 0);
+        CHECK(end.copy_to(buf, 7) == 0);
+    };
+    check(c.begin_order(), c.end_order());
+    check(c.begin_reverse_order(), c.end_reverse_order());
+    check(c.begin_ascending_order(), c.end_ascending_order());
+    check(c.begin_descending_order(), c.end_descending_order());
+    check(c.begin_side_cross_order(), c.end_side_cross_order());
+    check(c.begin_middle_out_order(), c.end_middle_out_order());
+}
+
+// Vectorized scan kernels (find / count / remove)
+
+TEST_CASE("SimdScan - every dispatch level matches std::find/count/remove") {
+    std::vector<SimdLevel> levels{SimdLevel::Scalar};
+    if (detectSimdLevel() >= SimdLevel::SSE2) levels.push_back(SimdLevel::SSE2);
+    if (detectSimdLevel() >= SimdLevel::AVX2) levels.push_back(SimdLevel::AVX2);
+
+    auto check = [&](auto sample) {
+        using T = decltype(sample);
+        std::mt19937 rng(17);
+        for (std::size_t n : {0u, 1u, 7u, 31u, 32u, 33u, 100u, 1000u}) {
+            std::vector<T> v(n);
+            for (auto& x : v) x = static_cast<T>(rng() % 5);
+            const T needle = static_cast<T>(2);
+            const std::size_t first = static_cast<std::size_t>(std::find(v.begin(), v.end(), needle) - v.begin());
+            std::vector<T> expected = v;
+            expected.erase(std::remove(expected.begin(), expected.end(), needle), expected.end());
+            for (SimdLevel l : levels) {
+                CAPTURE(toString(l));
+                CAPTURE(n);
+                CHECK(findEqual(v.data(), n, needle, l) == first);
+                CHECK(countEqual(v.data(), n, needle, l) == static_cast<std::size_t>(std::count(v.begin(), v.end(), needle)));
+                std::vector<T> w = v;
+                w.resize(removeEqual(w.data(), n, needle, std::min(first, n), l));
+                CHECK(w == expected);
+            }
+        }
+    };
+    check(static_cast<signed char>(0));
+    check(static_cast<std::uint16_t>(0));
+    check(0);
+    check(0.0f);
+    check(static_cast<std::int64_t>(0));
+    check(0.0);
+
+    double nan = std::nan("");
+    std::vector<double> d{nan, -0.0, 1.0, 0.0, nan, 0.0, 2.0, 3.0, 0.0};
+    for (SimdLevel l : levels) {
+        CHECK(countEqual(d.data(), d.size(), 0.0, l) == 4);        // -0.0 == 0.0
+        CHECK(countEqual(d.data(), d.size(), nan, l) == 0);        // NaN never compares equal
+    }
+}
+
+TEST_CASE("MyContainer - count and removeElement use the scan kernels") {
+    MyContainer<int> c;
+    for (int i = 0; i < 1000; ++i) c.addElement(i % 7);
+    CHECK(c.count(3) == 143);
+    CHECK(c.count(9) == 0);
+    c.removeElement(3);
+    CHECK(c.count(3) == 0);
+    CHECK(c.size() == 857);
+    CHECK_THROWS_AS(c.removeElement(3), std::runtime_error);
+    std::vector<int> expected;
+    for (int i = 0; i < 1000; ++i) if (i % 7 != 3) expected.push_back(i % 7);
+    CHECK(c.getData() == expected);
+
+    MyContainer<std::string> s;
+    for (const char* w : {"a", "b", "a", "c"}) s.addElement(w);
+    CHECK(s.count("a") == 2);
+    s.removeElement("a");
+    CHECK(s.getData() == std::vector<std::string>{"b", "c"});
+}
+
+// Aggregates (sum / mean / variance)
+
+TEST_CASE("SimdReduce - sum and variance agree across levels, types and thread counts") {
+    auto check = [](auto sample) {
+        using T = decltype(sample);
+        std::mt19937 rng(23);
+        for (std::size_t n : {0u, 1u, 7u, 8u, 9u, 1000u, 300000u}) {
+            std::vector<T> v(n);
+            for (auto& x : v) x = static_cast<T>(static_cast<int>(rng() % 200) - (std::is_signed_v<T> ? 100 : 0));
+            long double exact = 0;
+            for (T x : v) exact += static_cast<long double>(x);
+            long double sq = 0;
+            const long double m = n ? exact / n : 0;
+            for (T x : v) sq += (x - m) * (x - m);
+            for (SimdLevel l : {SimdLevel::Scalar, detectSimdLevel()}) {
+                for (std::size_t threads : {1u, 4u}) {
+                    CAPTURE(n);
+                    CAPTURE(threads);
+                    CHECK(static_cast<long double>(sumOf(v.data(), n, threads, l)) == doctest::Approx(static_cast<double>(exact)));
+                    if (n) CHECK(varianceOf(v.data(), n, static_cast<double>(m), threads, l) == doctest::Approx(static_cast<double>(sq / n)));
+                }
+            }
+        }
+    };
+    check(static_cast<std::int8_t>(0));
+    check(static_cast<std::uint16_t>(0));
+    check(0);
+    check(0u);
+    check(static_cast<std::int64_t>(0));
+    check(0.0f);
+    check(0.0);
+
+    std::vector<int> big(1u << 20, -7);
+    CHECK(sumOf(big.data(), big.size()) == -7LL * (1 << 20));    // No 32-bit overflow
+}
+
+TEST_CASE("SimdReduce - compensated summation keeps the small terms") {
+    std::vector<double> v{1e16};
+    for (int i = 0; i < 10000; ++i) v.push_back(1.0);
+    v.push_back(-1e16);
+    for (SimdLevel l : {SimdLevel::Scalar, detectSimdLevel()}) {
+        CHECK(sumOf(v.data(), v.size(), 1, l) == 10000.0);         // Naive summation returns 0
+    }
+
+    if (std::numeric_limits<long double>::digits > 60) {             // x87 extended precision
+        const long double x = 1.0L + std::ldexp(1.0L, -60);           // Rounds to 1.0 as a double
+        std::vector<long double> wide(8, x);
+        CHECK(sumOf(wide.data(), wide.size()) == 8.0L + std::ldexp(1.0L, -57));
+    }
+}
+
+TEST_CASE("SimdReduce - parallelReduce joins its workers before rethrowing") {
+    const std::size_t n = 4 * simd_detail::kMinParallelChunk;
+    std::atomic<int> finished{0};
+    auto chunk = [&](std::size_t first, std::size_t) {
+        if (first == 0) throw std::runtime_error("chunk failed");    // Caller's own chunk
+        ++finished;
+        return 1;
+    };
+    auto merge = [](int& a, const int& b) { a += b; };
+    CHECK_THROWS_AS(simd_detail::parallelReduce<int>(n, 4, chunk, merge), std::runtime_error);
+    CHECK(finished == 3);                                             // Workers ran to completion
+}
+
+TEST_CASE("MyContainer - sum, mean and variance") {
+    MyContainer<int> c;
+    CHECK(c.sum() == 0);
+    CHECK_THROWS_AS(c.mean(), std::runtime_error);
+    CHECK_THROWS_AS(c.variance(), std::runtime_error);
+    for (int x : {2, 4, 4, 4, 5, 5, 7, 9}) c.addElement(x);
+    CHECK(c.sum() == 40);
+    CHECK(c.mean() == 5.0);
+    CHECK(c.variance() == doctest::Approx(4.0));
+    CHECK(c.variance(0) == doctest::Approx(4.0));
+
+    MyContainer<double> d;
+    for (int i = 0; i < 200000; ++i) d.addElement(1e9 + (i % 2 ? 0.5 : -0.5));
+    CHECK(d.mean(0) == doctest::Approx(1e9));
+    CHECK(d.variance(0) == doctest::Approx(0.25));                  // Naive E[x^2] - E[x]^2 loses this entirely
+
+    MyContainer<long long> wide;                                      // sum() wraps here, mean() must not
+    wide.addElement(LLONG_MAX);
+    wide.addElement(LLONG_MAX);
+    CHECK(wide.mean() == static_cast<double>(LLONG_MAX));
+    CHECK(wide.variance() == 0.0);
+    wide.addElement(LLONG_MIN);
+    wide.addElement(LLONG_MIN);
+    CHECK(std::fabs(wide.mean() + 0.5) <= 1.0);                      // Exact -0.5 with x87 long double
+    CHECK(wide.variance() == doctest::Approx(std::ldexp(1.0, 126)));
+
+    MyContainer<unsigned long long> uwide;
+    for (int i = 0; i < 3; ++i) uwide.addElement(ULLONG_MAX);
+    CHECK(uwide.mean() == static_cast<double>(ULLONG_MAX));
+}
+
+// Argsort
+
+TEST_CASE("argsort - stable permutation shared with the sorted orders") {
+    MyContainer<int> c;
+    for (int x : {5, 1, 4, 1, 3, 5, 0}) c.addElement(x);
+    auto p = c.argsort();
+    CHECK(*p == std::vector<std::uint32_t>{6, 1, 3, 4, 2, 0, 5});    // Ties keep insertion order
+    CHECK(c.isIndexWarm());
+    CHECK(c.argsort() == p);                                          // Cached
+
+    AllocationCounter a;
+    auto asc = c.begin_ascending_order();
+    auto desc = c.begin_descending_order();
+    auto side = c.begin_side_cross_order();
+    std::size_t allocations = a.count();
+    CHECK(allocations == 0);                                          // Orders reuse the argsort keys
+    for (std::uint32_t pos : *p) CHECK(*asc++ == c.getData()[pos]);
+    CHECK(*desc == 5);
+    CHECK(*side == 0);
+
+    c.addElement(2);
+    CHECK(p->size() == 7);                                            // Old permutation is a snapshot
+    CHECK(c.argsort()->size() == 8);
+
+    std::mt19937 rng(5);
+    MyContainer<std::string> s;
+    for (int i = 0; i < 40; ++i) s.addElement("k" + std::to_string(i < 20 ? i : rng() % 50));
+    auto q = s.argsort();
+    REQUIRE(q->size() == 40);
+    for (std::size_t i = 1; i < q->size(); ++i) {
+        const std::string& prev = s.getData()[(*q)[i - 1]];
+        const std::string& cur = s.getData()[(*q)[i]];
+        CHECK((prev < cur || (prev == cur && (*q)[i - 1] < (*q)[i])));
+    }
+    CHECK(s.sortStrategy() == SortStrategy::PrefixMerge);             // Ascending prefix "k0".."k9" is only merged
+}
+
+// Stable sorted orders
+
+TEST_CASE("Stable order - ties follow insertion order, arithmetic keys use packed radix") {
+    MyContainer<Book> books;
+    books.setStableOrder(true);
+    CHECK(books.isStableOrder());
+    for (int i = 0; i < 60; ++i) books.addElement(Book{"b" + std::to_string(i), (i * 7) % 5});
+    std::vector<Book> asc;
+    for (auto it = books.begin_ascending_order(); it != books.end_ascending_order(); ++it) asc.push_back(*it);
+    std::vector<Book> expected = books.getData();
+    std::stable_sort(expected.begin(), expected.end());
+    CHECK(asc == expected);
+    std::vector<Book> desc;
+    for (auto it = books.begin_descending_order(); it != books.end_descending_order(); ++it) desc.push_back(*it);
+    CHECK(desc == std::vector<Book>(expected.rbegin(), expected.rend()));
+
+    MyContainer<float> f;
+    f.setStableOrder(true);
+    std::mt19937 rng(3);
+    for (int i = 0; i < 1000; ++i) f.addElement(static_cast<float>(static_cast<int>(rng() % 41) - 20) / 4.0f);
+    f.addElement(-0.0f);
+    f.addElement(0.0f);
+    f.addElement(-0.0f);
+    auto p = f.argsort();
+    CHECK(f.sortStrategy() == SortStrategy::Radix);
+    std::vector<std::uint32_t> ref(f.size());
+    std::iota(ref.begin(), ref.end(), 0u);
+    std::stable_sort(ref.begin(), ref.end(), [&](std::uint32_t a, std::uint32_t b) { return f.getData()[a] < f.getData()[b]; });
+    CHECK(*p == ref);                                                  // -0.0 and 0.0 tie by position
+
+    f.setStableOrder(false);
+    CHECK_FALSE(f.isIndexWarm());
+}
+
+// Distinct-value orders
+
+TEST_CASE("Unique orders - one representative per run, distinct_count cached") {
+    MyContainer<int> c;
+    CHECK(c.distinct_count() == 0);
+    CHECK(c.begin_unique_ascending_order() == c.end_unique_ascending_order());
+    for (int x : {4, 1, 4, 9, 1, 1, 7, 4}) c.addElement(x);
+    CHECK(c.distinct_count() == 4);
+
+    std::vector<int> asc, desc;
+    for (auto it = c.begin_unique_ascending_order(); it != c.end_unique_ascending_order(); ++it) asc.push_back(*it);
+    for (auto it = c.begin_unique_descending_order(); it != c.end_unique_descending_order(); ++it) desc.push_back(*it);
+    CHECK(asc == std::vector<int>{1, 4, 7, 9});
+    CHECK(desc == std::vector<int>{9, 7, 4, 1});
+
+    AllocationCounter a;
+    CHECK(c.distinct_count() == 4);
+    auto again = c.begin_unique_ascending_order();
+    std::size_t allocations = a.count();
+    CHECK(allocations == 0);                                          // Warm: nothing rebuilt
+
+    c.removeElement(4);
+    CHECK(c.distinct_count() == 3);
+    CHECK(*again == 1);                                               // Old iterators keep their snapshot
+    int buf[4];
+    CHECK(again.next_batch(buf, 4) == 4);
+    CHECK(buf[1] == 4);
+
+    MyContainer<int> sorted;
+    for (int i = 0; i < 100; ++i) sorted.addElement(i / 10);
+    CHECK(sorted.distinct_count() == 10);                             // Sorted data: no index needed
+    CHECK(sorted.sortStrategy() == SortStrategy::AlreadySorted);
+
+    MyContainer<Book> books;
+    books.setStableOrder(true);
+    books.addElement(Book{"b", 100});
+    books.addElement(Book{"a", 50});
+    books.addElement(Book{"c", 100});
+    CHECK(books.distinct_count() == 2);
+    CHECK((*books.begin_unique_descending_order()).title == "b");     // First of the run in stable order
+}
+
+// Frequency tables and histograms
+
+TEST_CASE("value_counts - ascending distinct values with multiplicities") {
+    MyContainer<std::string> c;
+    for (const char* w : {"pear", "apple", "pear", "fig", "pear", "apple"}) c.addElement(w);
+    auto vc = c.value_counts();
+    CHECK(vc == std::vector<std::pair<std::string, std::size_t>>{{"apple", 2}, {"fig", 1}, {"pear", 3}});
+    CHECK(MyContainer<int>().value_counts().empty());
+}
+
+TEST_CASE("histogram - equal-width buckets agree across dispatch levels") {
+    MyContainer<int> c;
+    for (int x : {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10}) c.addElement(x);
+    CHECK(c.histogram(5) == std::vector<std::size_t>{2, 2, 2, 2, 3});    // Last bucket includes max
+    CHECK(c.histogram(2, 3, 6) == std::vector<std::size_t>{2, 2});       // 3 4 | 5 6 (others ignored)
+    CHECK(c.histogram(1, 4, 4) == std::vector<std::size_t>{1});
+    CHECK_THROWS_AS(c.histogram(0), std::invalid_argument);
+    CHECK_THROWS_AS(c.histogram(3, 5, 4), std::invalid_argument);
+    CHECK(MyContainer<double>().histogram(3) == std::vector<std::size_t>(3, 0));
+
+    std::mt19937 rng(11);
+    std::normal_distribution<double> normal(0.0, 3.0);
+    std::vector<double> d(10007);
+    for (auto& x : d) x = normal(rng);
+    d.push_back(std::nan(""));
+    std::vector<std::int16_t> s(5003);
+    for (auto& x : s) x = static_cast<std::int16_t>(rng() % 2000) - 1000;
+    for (SimdLevel l : {SimdLevel::Scalar, detectSimdLevel()}) {
+        auto hd = histogramOf(d.data(), d.size(), -5.0, 5.0, 37, l);
+        auto hs = histogramOf(s.data(), s.size(), -1000.0, 999.0, 64, l);
+        CHECK(hd == histogramOf(d.data(), d.size(), -5.0, 5.0, 37, SimdLevel::Scalar));
+        CHECK(hs == histogramOf(s.data(), s.size(), -1000.0, 999.0, 64, SimdLevel::Scalar));
+        CHECK(std::accumulate(hs.begin(), hs.end(), std::size_t{0}) == s.size());
+        std::size_t inside = 0;
+        for (double x : d) inside += (x >= -5.0 && x <= 5.0);
+        CHECK(std::accumulate(hd.begin(), hd.end(), std::size_t{0}) == inside);
+
+        const std::vector<double> huge{-1e308, -4e307, 1e307, 6e307, 1e308, 0.0, -1e308, 1e308};
+        CHECK(histogramOf(huge.data(), huge.size(), -1e308, 1e308, 4, l) ==
+              std::vector<std::size_t>{2, 1, 2, 3});                  // hi - lo overflows to infinity
+    }
+    MyContainer<double> extremes;
+    extremes.addElement(-1e308);
+    extremes.addElement(1e308);
+    CHECK(extremes.histogram(4) == std::vector<std::size_t>{1, 0, 0, 1});
+}
+
+// Heavy hitters
+
+TEST_CASE("Heavy hitters - Count-Min + top-k follow adds and removes") {
+    MyContainer<int> c;
+    CHECK_THROWS_AS(c.heavy_hitters(), std::runtime_error);
+    for (int i = 0; i < 50; ++i) c.addElement(7);                     // Counted when tracking starts
+    c.enableHeavyHitters(3, 1024, 4);
+    CHECK(c.isTrackingHeavyHitters());
+
+    std::mt19937 rng(29);
+    for (int i = 0; i < 20000; ++i) {
+        const std::uint32_t r = rng() % 100;
+        if (r < 10) c.addElement(1);
+        else if (r < 15) c.addElement(2);
+        else if (r < 18) c.addElement(3);
+        else c.addElement(1000 + static_cast<int>(rng() % 50000));    // Long tail
+    }
+    auto top = c.heavy_hitters();
+    REQUIRE(top.size() == 3);
+    CHECK(top[0].first == 1);
+    CHECK(top[1].first == 2);
+    CHECK(top[2].first == 3);
+    for (const auto& [value, estimate] : top) CHECK(estimate >= c.count(value));
+    CHECK(c.estimated_count(7) >= 50);
+
+    MyContainer<int> copy = c;                                        // Copy-on-write sketch
+    c.removeElement(1);
+    top = c.heavy_hitters();
+    CHECK(top[0].first == 2);
+    CHECK(std::none_of(top.begin(), top.end(), [](const auto& e) { return e.first == 1; }));
+    CHECK(copy.heavy_hitters()[0].first == 1);
+
+    MyContainer<std::string> words;
+    words.enableHeavyHitters(2);
+    for (const char* w : {"a", "b", "a", "c", "a", "b"}) words.addElement(w);
+    CHECK(words.heavy_hitters() == std::vector<std::pair<std::string, std::size_t>>{{"a", 3}, {"b", 2}});
+    words.disableHeavyHitters();
+    CHECK_FALSE(words.isTrackingHeavyHitters());
+}
+
+TEST_CASE("Bloom filter - rejects absent removals and stays in sync with adds and removes") {
+    CountingBloomFilter<int> filter(1000, 0.01);
+    for (int i = 0; i < 1000; ++i) filter.add(i);
+    int falsePositives = 0;
+    for (int i = 1000; i < 11000; ++i) falsePositives += filter.mayContain(i);
+    CHECK(falsePositives < 300);                                      // ~1% target, generous margin
+    for (int i = 0; i < 1000; ++i) CHECK(filter.mayContain(i));       // No false negatives
+    CHECK_THROWS_AS(CountingBloomFilter<int>(10, 1.0), std::invalid_argument);
+
+    MyContainer<int> c;
+    for (int i = 0; i < 100; ++i) c.addElement(i % 10);
+    c.enableBloomFilter();
+    CHECK(c.isBloomFilterEnabled());
+    CHECK(c.tryRemoveElement(42) == 0);
+    CHECK_THROWS_AS(c.removeElement(42), std::runtime_error);
+    CHECK(c.tryRemoveElement(3) == 10);
+    CHECK(c.tryRemoveElement(3) == 0);
+    CHECK(c.size() == 90);
+
+    MyContainer<int> copy = c;                                        // Copy-on-write filter
+    for (int i = 0; i < 5000; ++i) c.addElement(1000 + i);            // Grows past its capacity
+    for (int i = 0; i < 5000; i += 7) CHECK(c.tryRemoveElement(1000 + i) == 1);
+    CHECK(c.tryRemoveElement(1000) == 0);
+    CHECK(copy.tryRemoveElement(1000) == 0);
+    copy.removeElement(5);
+    CHECK(c.count(5) == 10);
+
+    std::mt19937 rng(31);
+    MyContainer<int> checked;
+    checked.enableBloomFilter(64);
+    std::vector<int> reference;
+    for (int i = 0; i < 4000; ++i) {
+        const int v = static_cast<int>(rng() % 200);
+        if (rng() % 3 == 0) {
+            const auto expected = static_cast<std::size_t>(std::count(reference.begin(), reference.end(), v));
+            reference.erase(std::remove(reference.begin(), reference.end(), v), reference.end());
+            CHECK(checked.tryRemoveElement(v) == expected);
+        } else {
+            reference.push_back(v);
+            checked.addElement(v);
+        }
+    }
+    CHECK(checked.getData() == reference);
+
+    MyContainer<std::string> words;
+    words.enableBloomFilter(16, 0.001);
+    words.addElement("apple");
+    CHECK(words.tryRemoveElement("pear") == 0);
+    CHECK(words.tryRemoveElement("apple") == 1);
+    words.disableBloomFilter();
+    CHECK_FALSE(words.isBloomFilterEnabled());
+    CHECK(words.tryRemoveElement("apple") == 0);                      // Still non-throwing without a filter
+}
+
+TEST_CASE("HyperLogLog - approx_distinct tracks adds, rebuilds after removals, merges shards") {
+    MyContainer<int> c;
+    CHECK_THROWS_AS(c.approx_distinct(), std::runtime_error);
+    CHECK_THROWS_AS(c.enableApproxDistinct(3), std::invalid_argument);
+    for (int i = 0; i < 1000; ++i) c.addElement(i % 100);             // Counted when tracking starts
+    c.enableApproxDistinct(12);
+    CHECK(c.isTrackingApproxDistinct());
+    CHECK(c.approx_distinct() == doctest::Approx(100).epsilon(0.05));  // Linear-counting range
+
+    for (int i = 0; i < 20000; ++i) c.addElement(i);
+    const double error = 4 * c.distinctSketch().standardError();      // 4 sigma
+    CHECK(c.approx_distinct() == doctest::Approx(20000).epsilon(error));
+    CHECK(c.approx_distinct() == doctest::Approx(static_cast<double>(c.distinct_count())).epsilon(error));
+
+    MyContainer<int> copy = c;                                        // Copy-on-write sketch
+    for (int i = 0; i < 15000; ++i) c.removeElement(i);               // Stale until the next query
+    CHECK(c.approx_distinct() == doctest::Approx(5000).epsilon(error));
+    CHECK(copy.approx_distinct() == doctest::Approx(20000).epsilon(error));
+
+    MyContainer<int> shardA, shardB;                                  // Overlapping shards
+    shardA.enableApproxDistinct(12);
+    shardB.enableApproxDistinct(12);
+    for (int i = 0; i < 60000; ++i) shardA.addElement(i);
+    for (int i = 40000; i < 100000; ++i) shardB.addElement(i);
+    HyperLogLog<int> all = shardA.distinctSketch();
+    all.merge(shardB.distinctSketch());
+    CHECK(all.estimate() == doctest::Approx(100000).epsilon(error));
+    CHECK_THROWS_AS(all.merge(HyperLogLog<int>(10)), std::invalid_argument);
+
+    MyContainer<std::string> words;
+    words.enableApproxDistinct();
+    for (const char* w : {"a", "b", "a", "c"}) words.addElement(w);
+    CHECK(words.approx_distinct() == doctest::Approx(3).epsilon(0.01));
+    words.disableApproxDistinct();
+    CHECK_FALSE(words.isTrackingApproxDistinct());
+}
+
+TEST_CASE("batch() - commit matches sequential add/remove calls and is all-or-nothing") {
+    std::mt19937 rng(37);
+    for (int round = 0; round < 40; ++round) {
+        MyContainer<int> batched, sequential;
+        batched.enableBloomFilter(8);
+        batched.enableHeavyHitters(2);
+        for (int i = 0; i < 300; ++i) {
+            const int v = static_cast<int>(rng() % 40);
+            batched.addElement(round % 2 ? v : i);                    // Odd rounds unsorted, even rounds ascending
+            sequential.addElement(round % 2 ? v : i);
+        }
+        if (round % 4 < 2) (void)batched.sortedSnapshot();            // Warm index is patched, not rebuilt
+
+        auto snapshot = batched.snapshot();
+        const std::vector<int> before = *snapshot;
+        auto tx = batched.batch();
+        for (int op = 0; op < 60; ++op) {
+            const int v = static_cast<int>(rng() % 50);
+            if (rng() % 3 == 0 && sequential.contains(v)) {
+                tx.remove(v);
+                sequential.removeElement(v);
+            } else {
+                tx.add(v);
+                sequential.addElement(v);
+            }
+        }
+        CHECK(batched.getData() == before);                           // Nothing applied before commit
+        tx.commit();
+        CHECK(tx.size() == 0);
+        CHECK(*snapshot == before);                                   // Earlier snapshot untouched
+        REQUIRE(batched.getData() == sequential.getData());
+        CHECK(batched.stats().adds == sequential.stats().adds);       // Counted like the equivalent calls
+        CHECK(batched.stats().removes == sequential.stats().removes);
+        CHECK(batched.stats().commits == 1);
+        if (round % 4 == 1) CHECK(batched.isIndexWarm());             // Unsorted + warm: patched
+        CHECK(batched.sortedPrefixLength() >= sequential.sortedPrefixLength()); // Recomputed, never shorter
+        CHECK(*batched.sortedSnapshot() == *sequential.sortedSnapshot());
+        CHECK(batched.min() == sequential.min());
+        CHECK(batched.max() == sequential.max());
+        for (int v = 0; v < 50; ++v) CHECK(batched.tryRemoveElement(v) == sequential.tryRemoveElement(v));
+    }
+
+    MyContainer<int> c;
+    auto tx = c.batch();
+    tx.add(1).add(2).remove(1).remove(1);                             // Second removal finds nothing
+    CHECK_THROWS_AS(tx.commit(), std::runtime_error);
+    CHECK(c.size() == 0);
+    CHECK(c.stats().adds == 0);                                       // A failed commit counts nothing
+    CHECK(c.stats().commits == 0);
+    CHECK(c.stats().commitLatency.count() == 1);
+    CHECK(tx.size() == 4);
+    tx.discard();
+    tx.add(1).remove(1).add(1).add(3);                                // Later adds survive earlier removals
+    tx.commit();
+    CHECK(c.getData() == std::vector<int>{1, 3});
+
+    MyContainer<Book> books;                                          // No std::hash, unequal equivalents
+    books.addElement(Book{"A", 100});
+    books.addElement(Book{"B", 50});
+    (void)books.sortedSnapshot();
+    auto bt = books.batch();
+    bt.add(Book{"C", 100}).remove(Book{"A", 100}).add(Book{"D", 10});
+    bt.commit();
+    std::vector<int> pages;
+    for (auto it = books.begin_ascending_order(); it != books.end_ascending_order(); ++it) pages.push_back((*it).pages);
+    CHECK(pages == std::vector<int>{10, 50, 100});
+    CHECK(books.size() == 3);
+}
+
+TEST_CASE("batch() - snapshot() on another thread sees each commit whole") {
+    constexpr int kBatches = 300, kPerBatch = 16;
+    MyContainer<int> c;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::thread reader([&] {
+        while (!done.load()) {
+            auto v = c.snapshot();
+            if (v->size() % kPerBatch != 0) ++torn;
+            for (std::size_t i = 0; i < v->size(); ++i) {
+                if ((*v)[i] != static_cast<int>(i / kPerBatch)) { ++torn; break; }
+            }
+        }
+    });
+    for (int b = 0; b < kBatches; ++b) {
+        auto tx = c.batch();
+        for (int i = 0; i < kPerBatch; ++i) tx.add(b);                // Pure adds: still a fresh vector
+        tx.commit();
+    }
+    done = true;
+    reader.join();
+    CHECK(torn.load() == 0);
+    CHECK(c.size() == static_cast<std::size_t>(kBatches * kPerBatch));
+}